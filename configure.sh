@@ -37,7 +37,8 @@ cd ..
 ################################################################################
 cd nauty
 echo 'About to configure NAUTY.';
-./configure || {
+# Thread-local workspaces make nauty safe to call from several threads.
+./configure --enable-tls || {
     echo -e '\e[31mFailed to configure NAUTY.\e[0m'
     exit 1
 }
@@ -0,0 +1,185 @@
+// Helpers for sets of vertices stored as runs of 64-bit words. A set over n
+// vertices occupies WordsNeeded(n) words and vertex 'v' is bit 'v % 64' of word
+// 'v / 64', counting from the most significant bit. This is the layout of sets
+// in nauty built with WORDSIZE 64, so a graph kept as n such sets (one per
+// vertex) is a nauty 'graph' with m = WordsNeeded(n) and can be passed to nauty
+// without conversion.
+
+#ifndef GRAPH_UTILS_BIT_UTILS_H_
+#define GRAPH_UTILS_BIT_UTILS_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace graph_utils {
+
+typedef uint64_t Word;
+
+const int kWordSize = 64;
+
+// Returns the number of words needed to hold a set over 'n' vertices.
+inline int WordsNeeded(const int n) { return (n + kWordSize - 1) / kWordSize; }
+
+// Returns the word of a set, which contains the given vertex.
+inline int WordIndex(const int v) { return v / kWordSize; }
+
+// Returns a mask with only the bit of 'v' set inside its word.
+inline Word BitMask(const int v) {
+  return Word(1) << (kWordSize - 1 - v % kWordSize);
+}
+
+// Returns a mask of all bits inside the word of 'v' which represent vertices
+// greater than 'v'.
+inline Word MaskAfter(const int v) {
+  const int bit = v % kWordSize;
+  return bit == kWordSize - 1 ? 0 : ~Word(0) >> (bit + 1);
+}
+
+// Returns the position inside its word of the smallest element of 'w', which
+// must not be zero. Similar to FIRSTBITNZ() in nauty.
+inline int FirstBit(const Word w) { return __builtin_clzll(w); }
+
+// Removes the smallest element of 'w', which must not be zero, and returns its
+// position inside the word. Similar to TAKEBIT() in nauty.
+inline int TakeFirstBit(Word *w) {
+  const int bit = FirstBit(*w);
+  *w ^= BitMask(bit);
+  return bit;
+}
+
+inline int PopCount(const Word w) { return __builtin_popcountll(w); }
+
+inline bool IsElement(const Word *set, const int v) {
+  return (set[WordIndex(v)] & BitMask(v)) != 0;
+}
+
+inline void AddElement(Word *set, const int v) {
+  set[WordIndex(v)] |= BitMask(v);
+}
+
+inline void DeleteElement(Word *set, const int v) {
+  set[WordIndex(v)] &= ~BitMask(v);
+}
+
+inline void EmptySet(Word *set, const int m) {
+  for (int i = 0; i < m; ++i) {
+    set[i] = 0;
+  }
+}
+
+// Returns the number of elements in the set of 'm' words.
+inline int SetSize(const Word *set, const int m) {
+  int count = 0;
+  for (int i = 0; i < m; ++i) {
+    count += PopCount(set[i]);
+  }
+  return count;
+}
+
+// Returns the number of elements common to both sets of 'm' words.
+inline int IntersectionSize(const Word *a, const Word *b, const int m) {
+  int count = 0;
+  for (int i = 0; i < m; ++i) {
+    count += PopCount(a[i] & b[i]);
+  }
+  return count;
+}
+
+// Returns true if the two sets of 'm' words have a common element.
+inline bool Intersects(const Word *a, const Word *b, const int m) {
+  for (int i = 0; i < m; ++i) {
+    if (a[i] & b[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if the three sets of 'm' words have a common element.
+inline bool Intersects(const Word *a, const Word *b, const Word *c,
+                       const int m) {
+  for (int i = 0; i < m; ++i) {
+    if (a[i] & b[i] & c[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the smallest element of the set greater than 'v', or -1 if there is
+// none. Pass v = -1 to get the first element. Similar to nextelement() in
+// nauty.
+inline int NextElement(const Word *set, const int m, const int v) {
+  int w = v < 0 ? 0 : WordIndex(v);
+  if (w >= m) {
+    return -1;
+  }
+  Word bits = v < 0 ? set[w] : set[w] & MaskAfter(v);
+  while (bits == 0) {
+    if (++w >= m) {
+      return -1;
+    }
+    bits = set[w];
+  }
+  return w * kWordSize + FirstBit(bits);
+}
+
+// Subsets of the first 64 vertices are also kept as single masks, with vertex
+// 'v' as bit 'v' counting from the least significant bit. The masks of all
+// non-empty subsets of n vertices are then the integers 1 to 2^n - 1, so they
+// can be enumerated by counting instead of being stored.
+typedef uint64_t SubsetMask;
+
+// The number of vertices a SubsetMask has room for.
+const int kSubsetMaskSize = 64;
+
+// Removes the smallest vertex of the subset 'mask', which must not be empty,
+// and returns it.
+inline int TakeSubsetVertex(SubsetMask *mask) {
+  const int v = __builtin_ctzll(*mask);
+  *mask &= *mask - 1;
+  return v;
+}
+
+// Sets the set of 'm' words to the vertices of the subset 'mask'.
+inline void SubsetMaskToSet(SubsetMask mask, Word *set, const int m) {
+  EmptySet(set, m);
+  while (mask) {
+    AddElement(set, TakeSubsetVertex(&mask));
+  }
+}
+
+// A scratch set of 'm' words. Sets of up to kInlineWords words are kept inside
+// the object, so that the common case of small graphs does not touch the heap.
+class WordSet {
+public:
+  explicit WordSet(const int m) {
+    if (m > kInlineWords) {
+      heap_words_.resize(m, 0);
+      words_ = heap_words_.data();
+    } else {
+      words_ = inline_words_;
+      EmptySet(words_, m);
+    }
+  }
+
+  Word *data() { return words_; }
+  const Word *data() const { return words_; }
+  Word &operator[](const int i) { return words_[i]; }
+  Word operator[](const int i) const { return words_[i]; }
+
+private:
+  static const int kInlineWords = 4;
+
+  WordSet(const WordSet &);
+  WordSet &operator=(const WordSet &);
+
+  Word inline_words_[kInlineWords];
+  std::vector<Word> heap_words_;
+  Word *words_;
+};
+
+} // namespace graph_utils
+
+#endif // GRAPH_UTILS_BIT_UTILS_H_
@@ -0,0 +1,65 @@
+// Implementation of BlockedBloomFilter.
+
+#include "blocked_bloom_filter.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+namespace graph_utils {
+namespace {
+
+const int kWordsPerBlock = BlockedBloomFilter::kBlockBits / 64;
+
+// Blocking costs about as much as a fifth more bits per item would gain.
+const double kBlockingOverhead = 1.2;
+
+} // namespace
+
+BlockedBloomFilter::BlockedBloomFilter(const size_t expected_items,
+                                       const double false_positive_rate) {
+  // The optimum of a plain Bloom filter: -ln(p) / ln(2)^2 bits per item and
+  // ln(2) times as many hashes as bits per item.
+  const double rate = std::min(0.5, std::max(1e-9, false_positive_rate));
+  const double bits_per_item =
+      kBlockingOverhead * -log(rate) / (log(2.0) * log(2.0));
+  const double bits = std::max<double>(1, expected_items) * bits_per_item;
+  num_blocks_ = std::max<size_t>(1, ceil(bits / kBlockBits));
+  num_hashes_ = std::min(16, std::max(1, static_cast<int>(
+                                             bits_per_item * log(2.0) + 0.5)));
+  words_.assign(num_blocks_ * kWordsPerBlock, 0);
+}
+
+size_t BlockedBloomFilter::GetBlock(const uint64_t hash) const {
+  // The high half of the hash picks the block without a division.
+  return static_cast<size_t>(((hash >> 32) * num_blocks_) >> 32) *
+         kWordsPerBlock;
+}
+
+void BlockedBloomFilter::Add(const uint64_t hash) {
+  uint64_t *block = &words_[GetBlock(hash)];
+  // The bits in the block come from the low half of the hash by double
+  // hashing. Only the low 9 bits of h1 and h2 count; h2 is odd, so that the
+  // bits of a hash are all different.
+  const uint32_t h1 = hash;
+  const uint32_t h2 = (hash >> 9) | 1;
+  for (int i = 0; i < num_hashes_; ++i) {
+    const uint32_t bit = (h1 + i * h2) % kBlockBits;
+    block[bit / 64] |= 1ULL << (bit % 64);
+  }
+}
+
+bool BlockedBloomFilter::MayContain(const uint64_t hash) const {
+  const uint64_t *block = &words_[GetBlock(hash)];
+  const uint32_t h1 = hash;
+  const uint32_t h2 = (hash >> 9) | 1;
+  for (int i = 0; i < num_hashes_; ++i) {
+    const uint32_t bit = (h1 + i * h2) % kBlockBits;
+    if ((block[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace graph_utils
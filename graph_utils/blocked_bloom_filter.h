@@ -0,0 +1,52 @@
+// A blocked Bloom filter of 64-bit hashes. It answers whether a hash may have
+// been added before: "no" is always right, "yes" is wrong with a small, tunable
+// probability. A checker puts it in front of its exact set, so that graphs that
+// are definitely new skip the exact lookup.
+//
+// All bits of a hash are set in a single block of one cache line, so a query
+// costs one cache miss at most. This makes the false positive rate a little
+// higher than that of a plain Bloom filter of the same size, which the sizing
+// below makes up for.
+
+#ifndef GRAPH_UTILS_BLOCKED_BLOOM_FILTER_H_
+#define GRAPH_UTILS_BLOCKED_BLOOM_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace graph_utils {
+
+class BlockedBloomFilter {
+public:
+  // The bits of a block: a cache line of 64 bytes.
+  static const int kBlockBits = 512;
+
+  // Creates a filter for about 'expected_items' hashes, which keeps the rate
+  // of false positives near 'false_positive_rate' until that many are added.
+  BlockedBloomFilter(const size_t expected_items,
+                     const double false_positive_rate);
+
+  // Adds 'hash', which should be well mixed (see MixBits()).
+  void Add(const uint64_t hash);
+  // Returns false if 'hash' was definitely not added, and true if it may have
+  // been.
+  bool MayContain(const uint64_t hash) const;
+
+  size_t num_bytes() const { return words_.size() * sizeof(uint64_t); }
+  int num_hashes() const { return num_hashes_; }
+
+private:
+  // Returns the first word of the block of 'hash'.
+  size_t GetBlock(const uint64_t hash) const;
+
+  size_t num_blocks_;
+  // The number of bits set for every hash.
+  int num_hashes_;
+  std::vector<uint64_t> words_;
+};
+
+} // namespace graph_utils
+
+#endif // GRAPH_UTILS_BLOCKED_BLOOM_FILTER_H_
@@ -0,0 +1,52 @@
+// Unit tests for BlockedBloomFilter.
+
+#include "blocked_bloom_filter.h"
+
+#include "graph_fingerprint.h"
+#include "gtest/gtest.h"
+
+namespace graph_utils {
+
+TEST(BlockedBloomFilterTest, NoFalseNegatives) {
+  BlockedBloomFilter filter(10000, 0.01);
+  for (uint64_t i = 0; i < 10000; ++i) {
+    filter.Add(MixBits(i));
+  }
+  for (uint64_t i = 0; i < 10000; ++i) {
+    ASSERT_TRUE(filter.MayContain(MixBits(i)));
+  }
+}
+
+TEST(BlockedBloomFilterTest, FalsePositiveRate) {
+  const int n = 100000;
+  const double rates[] = {0.1, 0.01, 0.001};
+  for (int r = 0; r < 3; ++r) {
+    BlockedBloomFilter filter(n, rates[r]);
+    for (uint64_t i = 0; i < n; ++i) {
+      filter.Add(MixBits(i));
+    }
+    int false_positives = 0;
+    for (uint64_t i = n; i < 2 * n; ++i) {
+      if (filter.MayContain(MixBits(i))) {
+        ++false_positives;
+      }
+    }
+    // Within a factor of two of the target either way.
+    EXPECT_LT(false_positives, 2 * rates[r] * n);
+    EXPECT_GT(false_positives, rates[r] * n / 2);
+  }
+}
+
+TEST(BlockedBloomFilterTest, Size) {
+  BlockedBloomFilter small(1000, 0.01);
+  BlockedBloomFilter large(1000, 0.0001);
+  EXPECT_EQ(0, small.num_bytes() % (BlockedBloomFilter::kBlockBits / 8));
+  EXPECT_LT(small.num_bytes(), large.num_bytes());
+  EXPECT_LT(small.num_hashes(), large.num_hashes());
+  // About 10 bits per item for 1%, 20 for 0.01%.
+  EXPECT_LT(small.num_bytes(), 1000 * 12 / 8 + 64);
+  // An empty filter says no to everything.
+  EXPECT_FALSE(small.MayContain(MixBits(1)));
+}
+
+} // namespace graph_utils
@@ -2,18 +2,32 @@
 #include "canonical_graph_generator.h"
 
 #include <algorithm>
+#include <cassert>
 #include <ctime>
+#include <functional>
 #include <math.h>
 #include <set>
+#include <stdexcept>
 #include <stdio.h>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "girth_5_graph.h"
 #include "graph.h"
+#include "graph_arena.h"
+#include "graph_store.h"
 #include "graph_utilities.h"
+#include "nauty_utils/concurrent_isomorphism_checker.h"
+#include "nauty_utils/nauty_workspace.h"
 #include "nauty_utils/nauty_wrapper.h"
 
 using graph_utils::Graph;
+using nauty_utils::AutomorphismGroup;
+using nauty_utils::CanonicalForm;
+using nauty_utils::CanonicalizeBatch;
+using nauty_utils::ConcurrentIsomorphismChecker;
 using nauty_utils::IsomorphismChecker;
 using std::set;
 using std::vector;
@@ -23,51 +37,186 @@ using std::vector;
 namespace graph_utils {
 namespace {
 
-void DeleteVectorOfGraphs(vector<Graph *> *v) {
-  while (!v->empty()) {
-    delete v->back();
-    v->pop_back();
+// Returns the image of the subset 'mask' under the permutation 'generator'.
+SubsetMask MapSubset(SubsetMask mask, const vector<int> &generator) {
+  SubsetMask image = 0;
+  while (mask != 0) {
+    image |= SubsetMask(1) << generator[TakeSubsetVertex(&mask)];
   }
+  return image;
 }
 
 } // namespace
 
-CanonicalGraphGenerator::CanonicalGraphGenerator(const int n,
-                                                 CanonicalGraphFilter *filter) {
+const size_t SubsetOrbits::kMaxOrbitSize;
+const size_t SubsetOrbits::kTableSize;
+
+SubsetOrbits::SubsetOrbits(const vector<vector<int> > &generators)
+    : generators_(generators) {}
+
+bool SubsetOrbits::IsSmallestInOrbit(const SubsetMask mask) {
+  // Most subsets that are not the smallest of their orbits are mapped below
+  // themselves by a generator, which needs no walk.
+  for (size_t j = 0; j < generators_.size(); ++j) {
+    if (MapSubset(mask, generators_[j]) < mask) {
+      return false;
+    }
+  }
+  if (visited_.empty()) {
+    visited_.resize(kTableSize, 0);
+  }
+  const bool smallest = WalkOrbit(mask);
+  // Only the slots of the subsets visited are cleared for the next walk.
+  for (size_t i = 0; i < used_slots_.size(); ++i) {
+    visited_[used_slots_[i]] = 0;
+  }
+  used_slots_.clear();
+  return smallest;
+}
+
+bool SubsetOrbits::WalkOrbit(const SubsetMask mask) {
+  orbit_.clear();
+  orbit_.push_back(mask);
+  Visit(mask);
+  for (size_t i = 0; i < orbit_.size(); ++i) {
+    for (size_t j = 0; j < generators_.size(); ++j) {
+      const SubsetMask image = MapSubset(orbit_[i], generators_[j]);
+      if (image < mask) {
+        return false;
+      }
+      if (Visit(image)) {
+        if (orbit_.size() == kMaxOrbitSize) {
+          return true;
+        }
+        orbit_.push_back(image);
+      }
+    }
+  }
+  return true;
+}
+
+bool SubsetOrbits::Visit(const SubsetMask mask) {
+  // Open addressing with linear probing. The table has twice the slots of the
+  // largest orbit walked, and no subset is empty, so 0 marks a free slot.
+  size_t slot = (mask * 0x9e3779b97f4a7c15ULL) >> (64 - kTableBits);
+  while (visited_[slot] != 0) {
+    if (visited_[slot] == mask) {
+      return false;
+    }
+    slot = (slot + 1) & (kTableSize - 1);
+  }
+  visited_[slot] = mask;
+  used_slots_.push_back(slot);
+  return true;
+}
+
+UpperObjectBuilder::UpperObjectBuilder(const Graph &g, GraphArena *arena,
+                                       vector<Graph *> *upper_obj)
+    : n_(g.size()), m_(WordsNeeded(g.size() + 1)),
+      rows_((g.size() + 1) * m_, 0), current_(0), arena_(arena),
+      upper_obj_(upper_obj) {
+  for (int v = 0; v < n_; ++v) {
+    std::copy(g.GetRow(v), g.GetRow(v) + g.words_per_row(), &rows_[v * m_]);
+  }
+}
+
+void UpperObjectBuilder::Add(const SubsetMask subset) {
+  Word *new_row = &rows_[n_ * m_];
+  for (SubsetMask changed = current_ ^ subset; changed != 0;) {
+    const int v = TakeSubsetVertex(&changed);
+    if ((subset >> v) & 1) {
+      AddElement(&rows_[v * m_], n_);
+      AddElement(new_row, v);
+    } else {
+      DeleteElement(&rows_[v * m_], n_);
+      DeleteElement(new_row, v);
+    }
+  }
+  current_ = subset;
+  upper_obj_->push_back(arena_->NewGraph(n_ + 1, rows_.data()));
+}
+
+template <typename FilterType>
+BasicCanonicalGraphGenerator<FilterType>::BasicCanonicalGraphGenerator(
+    const int n, FilterType *filter) {
+  if (n > kSubsetMaskSize) {
+    throw std::invalid_argument(
+        "The order must be at most 64, the size of a SubsetMask.");
+  }
   filter_ = filter;
   target_size_ = n;
+  num_threads_ = 1;
+  deduplication_ = kIsomorphismStore;
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::GenerateUpperObjects(
+    const Graph &g, GraphArena *arena, vector<Graph *> *upper_obj) {
+  GenerateUpperObjects(g, NULL, arena, upper_obj);
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::
+    GenerateUpperObjectsUpToAutomorphism(const Graph &g, GraphArena *arena,
+                                         vector<Graph *> *upper_obj) {
+  AutomorphismGroup group;
+  IsomorphismChecker::GetAutomorphismGroup(GraphView(g), &group);
+  if (group.generators.empty()) {
+    GenerateUpperObjects(g, NULL, arena, upper_obj);
+    return;
+  }
+  SubsetOrbits orbits(group.generators);
+  GenerateUpperObjects(g, &orbits, arena, upper_obj);
 }
 
-void CanonicalGraphGenerator::GenerateUpperObjects(const Graph &g,
-                                                   vector<Graph *> *upper_obj) {
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::GenerateUpperObjects(
+    const Graph &g, SubsetOrbits *orbits, GraphArena *arena,
+    vector<Graph *> *upper_obj) {
   const int n = g.size();
-  vector<vector<int> *> all_subsets;
-  filter_->GetAllSubsetOfVertices(n, &all_subsets);
-  for (size_t i = 0; i < all_subsets.size(); ++i) {
-    if (!filter_->IsSubsetSafe(g, *all_subsets[i])) {
-      // Only safe sequences can be considered.
-      continue;
+  // The subsets of the vertices of 'g' and 'SubsetMask(1) << n' must fit.
+  assert(n < kSubsetMaskSize);
+  UpperObjectBuilder builder(g, arena, upper_obj);
+  if (filter_->HasHereditarySubsets()) {
+    AddSafeSubsets(g, n - 1, 0, orbits, &builder);
+  } else {
+    // The subsets are counted through as masks, in the order of their values.
+    const SubsetMask end = SubsetMask(1) << n;
+    for (SubsetMask subset = 1; subset < end; ++subset) {
+      // Only safe sequences can be considered. Of a safe subset's orbit only
+      // the smallest subset is kept, as the others give isomorphic upper
+      // objects.
+      if (filter_->IsSubsetSafe(g, subset) &&
+          (orbits == NULL || orbits->IsSmallestInOrbit(subset))) {
+        builder.Add(subset);
+      }
     }
-    // TODO(radkokotev) Improve implementation here. Manipulating strings may be
-    // slower than directly creating a new graph.
-    vector<string> matrix;
-    g.GetAdjMatrix(&matrix);
-    string newline = "";
-    for (size_t j = 0; j < matrix.size(); ++j) {
-      bool is_vertex_in_set =
-          std::binary_search(all_subsets[i]->begin(), all_subsets[i]->end(), j);
-      matrix[j] += is_vertex_in_set ? "1" : "0";
-      newline += is_vertex_in_set ? "1" : "0";
+  }
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::AddSafeSubsets(
+    const Graph &g, const int v, const SubsetMask subset,
+    SubsetOrbits *orbits, UpperObjectBuilder *builder) {
+  if (v < 0) {
+    if (subset != 0 &&
+        (orbits == NULL || orbits->IsSmallestInOrbit(subset))) {
+      builder->Add(subset);
     }
-    newline += "0"; // graph is simple
-    // Add the new line to the matrix and create the new graph.
-    matrix.push_back(newline);
-    upper_obj->push_back(new Graph(matrix));
+    return;
+  }
+  // Without 'v' first, so that the masks come out in increasing order as they
+  // do without backtracking. With 'v' only if that is safe: no superset of an
+  // unsafe subset is safe, so the whole subtree is cut.
+  AddSafeSubsets(g, v - 1, subset, orbits, builder);
+  if (filter_->IsSubsetExtensionSafe(g, subset, v)) {
+    AddSafeSubsets(g, v - 1, subset | (SubsetMask(1) << v), orbits, builder);
   }
 }
 
-void CanonicalGraphGenerator::GenerateLowerObjects(const Graph &g,
-                                                   vector<Graph *> *lower_obj) {
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::GenerateLowerObjects(
+    const Graph &g, GraphArena *arena, vector<Graph *> *lower_obj) {
   const int n = g.size();
   if (n <= 1) {
     return;
@@ -75,109 +224,299 @@ void CanonicalGraphGenerator::GenerateLowerObjects(const Graph &g,
   for (int i = 0; i < n; ++i) {
     // Reduce the graph g, by removing the vertex i and all edges incident on i.
     Graph *lower;
-    filter_->ReduceGraphByRemovingVertex(g, i, &lower);
+    filter_->ReduceGraphByRemovingVertex(g, i, arena, &lower);
     lower_obj->push_back(lower);
   }
 }
 
-void
-CanonicalGraphGenerator::GetAllRelatedLowerObjects(const Graph &g,
-                                                   vector<Graph *> *lower_obj) {
-  GenerateLowerObjects(g, lower_obj);
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::GetAllRelatedLowerObjects(
+    const Graph &g, GraphArena *arena, vector<Graph *> *lower_obj) {
+  GenerateLowerObjects(g, arena, lower_obj);
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::FindGraphsFromLowerObject(
+    const Graph &lower_obj, GraphArena *arena, vector<Graph *> *graphs) {
+  FindGraphsFromLowerObject(lower_obj, arena, &scratch_, graphs);
 }
 
-void
-CanonicalGraphGenerator::FindGraphsFromLowerObject(const Graph &lower_obj,
-                                                   vector<Graph *> *graphs) {
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::FindGraphsFromLowerObject(
+    const Graph &lower_obj, GraphArena *arena, GraphArena *scratch,
+    vector<Graph *> *graphs) {
+  const size_t scratch_size = scratch->size();
   vector<Graph *> candidates;
-  GenerateUpperObjects(lower_obj, &candidates);
+  GenerateUpperObjects(lower_obj, scratch, &candidates);
+  // Every candidate is 'lower_obj' plus this vertex.
+  const int new_vertex = lower_obj.size();
+  CanonicalForm canonical;
   for (size_t i = 0; i < candidates.size(); ++i) {
-    vector<int> can_lab;
-    IsomorphismChecker::GetCanonicalLabeling(*candidates[i], &can_lab);
-    Graph *reduced;
-    int vertex_to_remove =
-        std::find(can_lab.begin(), can_lab.end(), 0) - can_lab.begin();
-    filter_->ReduceGraphByRemovingVertex(*candidates[i], vertex_to_remove,
-                                         &reduced);
-    if (IsomorphismChecker::AreIsomorphic(lower_obj, *reduced)) {
-      graphs->push_back(new Graph(*candidates[i]));
+    // A single canonisation gives the labelling, the orbits and the canonical
+    // form, which the candidate caches for the checker.
+    IsomorphismChecker::Canonise(*candidates[i], &canonical);
+    const int vertex_to_remove =
+        std::find(canonical.lab.begin(), canonical.lab.end(), 0) -
+        canonical.lab.begin();
+    bool is_original;
+    if (canonical.orbits[vertex_to_remove] == canonical.orbits[new_vertex]) {
+      // An automorphism of the candidate maps the new vertex to the one
+      // removed, so removing it gives 'lower_obj' back.
+      is_original = true;
+    } else {
+      Graph *reduced;
+      filter_->ReduceGraphByRemovingVertex(*candidates[i], vertex_to_remove,
+                                           scratch, &reduced);
+      // The canonical form of 'lower_obj' is cached after the first candidate.
+      is_original = IsomorphismChecker::AreIsomorphic(lower_obj, *reduced);
+      scratch->Truncate(scratch->size() - 1); // Drops 'reduced'.
+    }
+    if (is_original) {
+      graphs->push_back(arena->NewGraph(*candidates[i]));
+    }
+  }
+  scratch->Truncate(scratch_size);
+}
+
+template <typename FilterType>
+bool BasicCanonicalGraphGenerator<FilterType>::IsCanonicalDeletion(
+    const Graph &child) const {
+  const int n = child.size();
+  const int new_vertex = n - 1;
+  vector<bool> is_cut_vertex;
+  child.GetCutVertices(&is_cut_vertex);
+  // The vertices that may be deleted are those of largest degree that leave
+  // the graph connected.
+  int max_degree = -1;
+  int num_deletable = 0;
+  for (int v = 0; v < n; ++v) {
+    if (is_cut_vertex[v]) {
+      continue;
     }
-    delete reduced;
+    if (child.Degree(v) > max_degree) {
+      max_degree = child.Degree(v);
+      num_deletable = 0;
+    }
+    if (child.Degree(v) == max_degree) {
+      ++num_deletable;
+    }
+  }
+  if (is_cut_vertex[new_vertex] || child.Degree(new_vertex) < max_degree) {
+    return false;
+  }
+  if (num_deletable == 1) {
+    return true;
+  }
+  // The tie is broken by the canonical labelling, up to automorphisms.
+  CanonicalForm canonical;
+  IsomorphismChecker::Canonise(child, &canonical);
+  for (int i = 0; i < n; ++i) {
+    const int v = canonical.lab[i];
+    if (!is_cut_vertex[v] && child.Degree(v) == max_degree) {
+      return canonical.orbits[v] == canonical.orbits[new_vertex];
+    }
+  }
+  return false;
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::ExtendGraphs(
+    const GraphStore &graphs, const size_t first, const size_t stride,
+    ConcurrentIsomorphismChecker *checker) {
+  // The arenas are local, so that the threads share nothing but the checker.
+  GraphArena candidates;
+  GraphArena scratch;
+  vector<PackedGraph> forms;
+  for (size_t graph_index = first; graph_index < graphs.size();
+       graph_index += stride) {
+    // The candidates of the previous graph are no longer needed.
+    candidates.Clear();
+    const Graph &g =
+        *candidates.NewGraph(graphs.order(), graphs.GetRows(graph_index));
+    vector<Graph *> upper_obj;
+    GenerateUpperObjectsUpToAutomorphism(g, &candidates, &upper_obj);
+#ifdef HYPOTHESIS_TEST // VERIFYING THE HYPOTHESIS
+    // All upper objects are canonised in one pass with one workspace.
+    forms.clear();
+    CanonicalizeBatch(upper_obj, &forms);
+    for (size_t i = 0; i < forms.size(); ++i) {
+      checker->AddCanonicalForm(forms[i]);
+    }
+#else
+    for (size_t i = 0; i < upper_obj.size(); ++i) {
+      vector<Graph *> related_lower_obj;
+      GetAllRelatedLowerObjects(*upper_obj[i], &candidates,
+                                &related_lower_obj);
+      vector<Graph *> originals;
+      for (size_t lower_index = 0;
+           lower_index < related_lower_obj.size() && originals.empty();
+           ++lower_index) {
+        FindGraphsFromLowerObject(*related_lower_obj[lower_index],
+                                  &candidates, &scratch, &originals);
+      }
+      while (!originals.empty()) {
+        checker->AddGraphToCheck(*originals.back());
+        originals.pop_back();
+      }
+    }
+#endif  // HYPOTHESIS_TEST
+  }
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::AddCanonicalChildren(
+    const Graph &g, GraphArena *scratch, vector<PackedGraph> *children) {
+  const size_t scratch_size = scratch->size();
+  vector<Graph *> upper_obj;
+  GenerateUpperObjectsUpToAutomorphism(g, scratch, &upper_obj);
+  // Two accepted children that are isomorphic are so by an isomorphism fixing
+  // the new vertex, which maps one subset to the other by an automorphism of
+  // 'g'. With one subset of every orbit, no two accepted children are.
+  const size_t first_child = children->size();
+  for (size_t i = 0; i < upper_obj.size(); ++i) {
+    if (IsCanonicalDeletion(*upper_obj[i])) {
+      // Cached by IsCanonicalDeletion() if it had to canonise the child.
+      children->push_back(IsomorphismChecker::GetCanonicalForm(*upper_obj[i]));
+    }
+  }
+  // Subsets whose orbits are too large to walk are all kept, so the children
+  // of 'g' may repeat. Being canonical forms, repeats are equal.
+  std::sort(children->begin() + first_child, children->end());
+  children->erase(std::unique(children->begin() + first_child, children->end()),
+                  children->end());
+  scratch->Truncate(scratch_size);
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::ExtendGraphsByCanonicalDeletion(
+    const GraphStore &graphs, const size_t first, const size_t stride,
+    vector<PackedGraph> *children) {
+  GraphArena scratch;
+  for (size_t graph_index = first; graph_index < graphs.size();
+       graph_index += stride) {
+    const Graph g(graphs.order(), graphs.GetRows(graph_index));
+    AddCanonicalChildren(g, &scratch, children);
   }
-  while (!candidates.empty()) {
-    delete candidates.back();
-    candidates.pop_back();
+}
+
+template <typename FilterType>
+size_t BasicCanonicalGraphGenerator<FilterType>::VisitDescendants(
+    const Graph &g, const GraphVisitor &visitor, GraphArena *scratch) {
+  if (g.size() >= target_size_) {
+    visitor(g);
+    return 1;
+  }
+  // Only the accepted children are kept while their subtrees are visited.
+  vector<PackedGraph> children;
+  AddCanonicalChildren(g, scratch, &children);
+  size_t count = 0;
+  Graph child(g.size() + 1);
+  for (size_t i = 0; i < children.size(); ++i) {
+    children[i].Unpack(&child);
+    count += VisitDescendants(child, visitor, scratch);
   }
+  return count;
 }
 
-void CanonicalGraphGenerator::GenerateGraphs(vector<Graph *> **result,
-                                             bool print_messages) {
-  vector<Graph *> *cur = new vector<Graph *>();
-  vector<Graph *> *next = nullptr;
+template <typename FilterType>
+size_t BasicCanonicalGraphGenerator<FilterType>::GenerateGraphsDepthFirst(
+    const GraphVisitor &visitor) {
+  Graph k2(2);
+  k2.AddEdge(0, 1);
+  GraphArena scratch;
+  return VisitDescendants(k2, visitor, &scratch);
+}
+
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::RunThreads(
+    const std::function<void(int)> &extend) {
+  if (num_threads_ <= 1) {
+    extend(0);
+    return;
+  }
+  vector<std::thread> threads;
+  for (int t = 0; t < num_threads_; ++t) {
+    threads.push_back(std::thread(extend, t));
+  }
+  for (size_t t = 0; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+}
 
-  Graph *k2 = new Graph(2);
-  k2->AddEdge(0, 1);
-  cur->push_back(k2);
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::GenerateGraphs(
+    GraphStore *result, bool print_messages) {
+  GraphStore cur(2);
+  GraphStore next(3);
+  Graph k2(2);
+  k2.AddEdge(0, 1);
+  cur.Append(k2);
 
   for (int n = 3; n <= target_size_; ++n) {
-    next = new vector<Graph *>();
+    next = GraphStore(n);
     std::clock_t start = std::clock();
-    IsomorphismChecker checker(true);
-
-    for (size_t graph_index = 0; graph_index < cur->size(); ++graph_index) {
-      const Graph &g = *(*cur)[graph_index];
-      vector<Graph *> upper_obj;
-      GenerateUpperObjects(g, &upper_obj);
-#ifdef HYPOTHESIS_TEST // VERIFYING THE HYPOTHESIS
-      while (!upper_obj.empty()) {
-        if (!checker.AddGraphToCheck(upper_obj.back())) {
-          // This graph is isomorphic to one already generated. Don't store it.
-          delete upper_obj.back();
-        }
-        upper_obj.pop_back();
+    const size_t stride = std::max(1, num_threads_);
+    if (deduplication_ == kCanonicalDeletion) {
+      vector<vector<PackedGraph> > children(stride);
+      RunThreads([&](int t) {
+        ExtendGraphsByCanonicalDeletion(cur, t, stride, &children[t]);
+      });
+      vector<PackedGraph> forms;
+      for (size_t t = 0; t < children.size(); ++t) {
+        forms.insert(forms.end(), children[t].begin(), children[t].end());
+        vector<PackedGraph>().swap(children[t]);
       }
-#else
-      for (int i = 0; i < upper_obj.size(); ++i) {
-        vector<Graph *> related_lower_obj;
-        GetAllRelatedLowerObjects(*upper_obj[i], &related_lower_obj);
-        vector<Graph *> originals;
-        for (int lower_index = 0;
-            lower_index < related_lower_obj.size() && originals.empty();
-            ++lower_index) {
-          FindGraphsFromLowerObject(*related_lower_obj[lower_index],
-                                    &originals);
-        }
-        DeleteVectorOfGraphs(&related_lower_obj);
-        while (!originals.empty()) {
-          if (!checker.AddGraphToCheck(originals.back())) {
-            delete originals.back();
-          }
-          originals.pop_back();
-        }
+      // Sorted as the checker sorts them, so both modes give the same order.
+      std::sort(forms.begin(), forms.end());
+      next.Reserve(forms.size());
+      for (size_t i = 0; i < forms.size(); ++i) {
+        forms[i].Unpack(&next);
       }
-      DeleteVectorOfGraphs(&upper_obj);
-#endif  // HYPOTHESIS_TEST
+    } else {
+      ConcurrentIsomorphismChecker checker;
+      RunThreads([&](int t) { ExtendGraphs(cur, t, stride, &checker); });
+      checker.GetAllNonIsomorphicGraphs(&next);
     }
-
-    checker.GetAllNonIsomorphicGraphs(next);
-    DeleteVectorOfGraphs(cur);
-    delete cur;
-    cur = next;
+    std::swap(cur, next);
 
     if (print_messages) {
       int connected = 0;
-      for (size_t i = 0; i < next->size(); ++i) {
-        if ((*next)[i]->IsConnected()) {
+      for (GraphStore::const_iterator it = cur.begin(); it != cur.end();
+           ++it) {
+        if ((*it).IsConnected()) {
           ++connected;
         }
       }
       printf("For v = %d there are in total %lu graphs; connected -> %d", n,
-             next->size(), connected);
+             cur.size(), connected);
       printf("  Time: %.3f ms\n",
              (std::clock() - start) / (double)(CLOCKS_PER_SEC) * 1000);
     }
   }
-  *result = next;
+  std::swap(*result, cur);
 }
 
+template <typename FilterType>
+void BasicCanonicalGraphGenerator<FilterType>::GenerateGraphs(
+    vector<Graph *> **result, bool print_messages) {
+  if (target_size_ < 3) {
+    *result = nullptr;
+    return;
+  }
+  GraphStore graphs(target_size_);
+  GenerateGraphs(&graphs, print_messages);
+  results_.Clear();
+  *result = new vector<Graph *>();
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    (*result)->push_back(results_.NewGraph(graphs.order(), graphs.GetRows(i)));
+  }
+}
+
+// The filters the generator can be used with. Any other filter is used through
+// BasicCanonicalGraphGenerator<CanonicalGraphFilter>.
+template class BasicCanonicalGraphGenerator<CanonicalGraphFilter>;
+template class BasicCanonicalGraphGenerator<DiamondFreeGraph>;
+template class BasicCanonicalGraphGenerator<Girth5Graph>;
+template class BasicCanonicalGraphGenerator<GirthNGraph>;
+
 } // namespace graph_utils
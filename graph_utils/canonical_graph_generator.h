@@ -5,41 +5,257 @@
 #ifndef GRAPH_UTILS_CANONICAL_GRAPH_GENERATOR_H_
 #define GRAPH_UTILS_CANONICAL_GRAPH_GENERATOR_H_
 
+#include <functional>
 #include <string>
+#include <vector>
 
 #include "graph.h"
+#include "graph_arena.h"
+#include "graph_store.h"
 #include "graph_utilities.h"
+#include "packed_graph.h"
+#include "nauty_utils/concurrent_isomorphism_checker.h"
 
 namespace graph_utils {
 
-class CanonicalGraphGenerator {
+// Creates the upper objects of a graph g of order n, one subset at a time, as
+// the subsets are found. The rows of g are copied once; only the edges of the
+// new vertex n change from one subset to the next, at the vertices where the
+// two masks differ.
+class UpperObjectBuilder {
 public:
-  CanonicalGraphGenerator(const int n, CanonicalGraphFilter *filter);
+  // The upper objects are created in 'arena' and appended to 'upper_obj'.
+  UpperObjectBuilder(const Graph &g, GraphArena *arena,
+                     std::vector<Graph *> *upper_obj);
 
-  // Generates all upper objects <g, W> for the given graph g.
-  void GenerateUpperObjects(const Graph &g, std::vector<Graph *> *upper_obj);
+  // Adds the upper object of g with the new vertex joined to 'subset'.
+  void Add(const SubsetMask subset);
+
+private:
+  const int n_;
+  const int m_;
+  std::vector<Word> rows_;
+  // The subset the new vertex is joined to in 'rows_'.
+  SubsetMask current_;
+  GraphArena *arena_;
+  std::vector<Graph *> *upper_obj_;
+};
+
+// Tells the subsets of the vertices of a graph that are the smallest of their
+// orbits under a group of automorphisms, given by its generators. Its buffers
+// are kept from one subset to the next.
+class SubsetOrbits {
+public:
+  // The orbits are walked up to this many subsets. A subset with a larger
+  // orbit is taken to be the smallest of it.
+  static const size_t kMaxOrbitSize = 1 << 12;
+
+  // 'generators' must outlive the object.
+  explicit SubsetOrbits(const std::vector<std::vector<int> > &generators);
+
+  // Returns false if some subset in the orbit of 'mask', which must not be
+  // empty, is smaller than 'mask'. The images of 'mask' under the generators
+  // are tried first; only if none is smaller is the orbit walked.
+  bool IsSmallestInOrbit(const SubsetMask mask);
+
+private:
+  static const int kTableBits = 13;
+  static const size_t kTableSize = size_t(1) << kTableBits;
+
+  // Returns false if the walk of the orbit of 'mask' along the generators
+  // reaches a smaller subset before kMaxOrbitSize subsets.
+  bool WalkOrbit(const SubsetMask mask);
+  // Marks 'mask' as visited and returns true if it was not before.
+  bool Visit(const SubsetMask mask);
+
+  const std::vector<std::vector<int> > &generators_;
+  // The subsets of the orbit walked so far.
+  std::vector<SubsetMask> orbit_;
+  // A hash table of the visited subsets, allocated by the first walk.
+  std::vector<SubsetMask> visited_;
+  // The slots of 'visited_' in use.
+  std::vector<size_t> used_slots_;
+};
+
+// The generator is a template over the type of its filter. With a concrete,
+// final filter such as DiamondFreeGraph the calls to IsSubsetSafe() are bound
+// at compile time and inlined into the generation loop; with
+// CanonicalGraphFilter they go through its virtual interface, which allows any
+// filter to be used. The template is explicitly instantiated for
+// CanonicalGraphFilter and the filters of this library only.
+//
+// All graphs are created in arenas (see GraphArena). The methods below take the
+// arena to create their graphs in; the overloads without one use an arena of
+// the generator, so their graphs live as long as the generator does.
+template <typename FilterType> class BasicCanonicalGraphGenerator {
+public:
+  // How GenerateGraphs() removes the isomorphic copies among the graphs of an
+  // order.
+  enum Deduplication {
+    // All graphs of the next order go into one isomorphism checker, so the
+    // checker holds the whole order at once.
+    kIsomorphismStore,
+    // McKay's canonical deletion: a graph is kept only if its new vertex is
+    // in the orbit of the vertex whose removal is canonical, see
+    // IsCanonicalDeletion(). With one subset of every orbit under the
+    // automorphisms of the parent, every graph is accepted or rejected on its
+    // own, so the hash set of the checker and the comparisons with it are
+    // gone. GenerateGraphs() still keeps the whole next order, which it sorts
+    // and returns, so its memory still grows with the number of graphs; use
+    // GenerateGraphsDepthFirst() for memory bounded by the target order.
+    kCanonicalDeletion,
+  };
+
+  // Called with every graph of the target order found by
+  // GenerateGraphsDepthFirst(). The graph is only valid during the call.
+  typedef std::function<void(const Graph &)> GraphVisitor;
+
+  // Throws std::invalid_argument if 'n' is larger than kSubsetMaskSize, as
+  // the subsets of the graphs of order n - 1 are kept as SubsetMasks.
+  BasicCanonicalGraphGenerator(const int n, FilterType *filter);
+
+  // Generates all upper objects <g, W> for the given graph g, of fewer than 64
+  // vertices. The subsets W are enumerated as SubsetMasks in increasing order
+  // and handed to the filter as such. If the filter has hereditary subsets,
+  // they are grown a vertex at a time and no superset of an unsafe subset is
+  // visited.
+  void GenerateUpperObjects(const Graph &g, GraphArena *arena,
+                            std::vector<Graph *> *upper_obj);
+  void GenerateUpperObjects(const Graph &g, std::vector<Graph *> *upper_obj) {
+    GenerateUpperObjects(g, &arena_, upper_obj);
+  }
+
+  // Same as above, but for one subset W of every orbit of the subsets of V(g)
+  // under Aut(g) only, as the others give isomorphic upper objects. A subset
+  // the filter accepts is kept if it is the smallest of its orbit, which is
+  // walked along the generators of Aut(g). Subsets whose orbits are too large
+  // to walk are kept as well.
+  void GenerateUpperObjectsUpToAutomorphism(const Graph &g, GraphArena *arena,
+                                            std::vector<Graph *> *upper_obj);
+  void GenerateUpperObjectsUpToAutomorphism(const Graph &g,
+                                            std::vector<Graph *> *upper_obj) {
+    GenerateUpperObjectsUpToAutomorphism(g, &arena_, upper_obj);
+  }
 
   // Generates all lower objects <g, v> for the given graph g. That is, for all
   // v in V(g) add the graphs g - v.
-  void GenerateLowerObjects(const Graph &g, std::vector<Graph *> *lower_obj);
+  void GenerateLowerObjects(const Graph &g, GraphArena *arena,
+                            std::vector<Graph *> *lower_obj);
+  void GenerateLowerObjects(const Graph &g, std::vector<Graph *> *lower_obj) {
+    GenerateLowerObjects(g, &arena_, lower_obj);
+  }
 
   // Implementation of f' mapping an upper object to a set of related lower
   // objects under the relation Rf.
-  void GetAllRelatedLowerObjects(const Graph &g,
+  void GetAllRelatedLowerObjects(const Graph &g, GraphArena *arena,
                                  std::vector<Graph *> *lower_obj);
+  void GetAllRelatedLowerObjects(const Graph &g,
+                                 std::vector<Graph *> *lower_obj) {
+    GetAllRelatedLowerObjects(g, &arena_, lower_obj);
+  }
 
   // For a given lower object finds back the possible original graphs.
-  void FindGraphsFromLowerObject(const Graph &lower_obj,
+  void FindGraphsFromLowerObject(const Graph &lower_obj, GraphArena *arena,
                                  std::vector<Graph *> *graphs);
+  void FindGraphsFromLowerObject(const Graph &lower_obj,
+                                 std::vector<Graph *> *graphs) {
+    FindGraphsFromLowerObject(lower_obj, &arena_, graphs);
+  }
+
+  // Returns true if removing the last vertex of 'child', a connected graph, is
+  // its canonical deletion. That vertex must have the largest degree of all
+  // vertices that are not cut vertices, and be in the orbit of the first of
+  // them in the canonical labelling. The graphs of the class are closed under
+  // this deletion as long as the filter is hereditary, since the graph left is
+  // connected again. The degrees reject most children without canonising them.
+  bool IsCanonicalDeletion(const Graph &child) const;
 
-  // Generates all graph by canonical construction.
+  // Sets the number of threads GenerateGraphs() extends the graphs of one
+  // order with. The default is a single thread, which runs on the calling one.
+  void set_num_threads(const int num_threads) { num_threads_ = num_threads; }
+  // The default is kIsomorphismStore.
+  void set_deduplication(const Deduplication deduplication) {
+    deduplication_ = deduplication;
+  }
+
+  // Generates all graph by canonical construction. Each order is kept in a
+  // GraphStore; 'result' is set to the graphs of the target order. The graphs
+  // are the canonical forms of their isomorphism classes, in an order that does
+  // not depend on the number of threads.
+  void GenerateGraphs(GraphStore *result, bool print_messages = false);
+
+  // Same as above, but the graphs in 'result' are owned by the generator and
+  // are valid until it is destroyed or this method is called again.
   void GenerateGraphs(vector<Graph *> **result, bool print_messages = false);
 
+  // Generates the same graphs as GenerateGraphs(), depth first: every graph
+  // is extended down to the target order before the next one is, by
+  // canonical deletion whatever set_deduplication() says. The graphs are
+  // handed to 'visitor' as soon as they are found, on the calling thread, in
+  // an order that differs from the one of GenerateGraphs(). Only the children
+  // accepted on the path to the current graph are kept, so memory does not
+  // grow with the number of graphs. Returns the number of graphs visited.
+  size_t GenerateGraphsDepthFirst(const GraphVisitor &visitor);
+
 private:
+  // Generates the upper objects of the subsets that are the smallest of their
+  // orbits under 'orbits', or of all subsets if 'orbits' is NULL.
+  void GenerateUpperObjects(const Graph &g, SubsetOrbits *orbits,
+                            GraphArena *arena, std::vector<Graph *> *upper_obj);
+  // Hands to 'builder' the non-empty safe subsets that agree with 'subset'
+  // on the vertices above 'v', in increasing order, by deciding on the
+  // vertices from 'v' down. 'subset' must be safe and the filter's safe
+  // subsets hereditary. Unless 'orbits' is NULL, only the subsets that are
+  // the smallest of their orbits are handed on.
+  void AddSafeSubsets(const Graph &g, const int v, const SubsetMask subset,
+                      SubsetOrbits *orbits, UpperObjectBuilder *builder);
+  // Same as the public method, but its temporary graphs are created in
+  // 'scratch', so that several threads can run it at once.
+  void FindGraphsFromLowerObject(const Graph &lower_obj, GraphArena *arena,
+                                 GraphArena *scratch,
+                                 std::vector<Graph *> *graphs);
+
+  // Adds the graphs of order n + 1 grown from every 'stride'-th graph of
+  // 'graphs', starting with the 'first' one, to 'checker'. Every thread of
+  // GenerateGraphs() runs this with a stride of the number of threads.
+  void ExtendGraphs(const GraphStore &graphs, const size_t first,
+                    const size_t stride,
+                    nauty_utils::ConcurrentIsomorphismChecker *checker);
+  // Same as above with kCanonicalDeletion: appends the canonical forms of the
+  // graphs of order n + 1 whose canonical deletion gives their parent to
+  // 'children'.
+  void ExtendGraphsByCanonicalDeletion(const GraphStore &graphs,
+                                       const size_t first, const size_t stride,
+                                       std::vector<PackedGraph> *children);
+  // Appends the canonical forms of the children of 'g' accepted by the
+  // canonical deletion to 'children', one per isomorphism class. The
+  // candidates are created in 'scratch' and destroyed before it returns.
+  void AddCanonicalChildren(const Graph &g, GraphArena *scratch,
+                            std::vector<PackedGraph> *children);
+  // Visits the graphs of the target order that descend from 'g', and returns
+  // their number.
+  size_t VisitDescendants(const Graph &g, const GraphVisitor &visitor,
+                          GraphArena *scratch);
+  // Runs 'extend(t)' for every thread t, on the calling thread if there is
+  // just one.
+  void RunThreads(const std::function<void(int)> &extend);
+
   int target_size_;
-  CanonicalGraphFilter *filter_;
+  int num_threads_;
+  Deduplication deduplication_;
+  FilterType *filter_;
+  // Graphs created by the overloads without an arena.
+  GraphArena arena_;
+  // The graphs handed out by GenerateGraphs(vector<Graph *> **).
+  GraphArena results_;
+  // Temporary graphs of FindGraphsFromLowerObject(), which are destroyed
+  // before it returns.
+  GraphArena scratch_;
 };
 
+typedef BasicCanonicalGraphGenerator<CanonicalGraphFilter>
+    CanonicalGraphGenerator;
+
 } // namespace graph_utils
 
 #endif // GRAPH_UTILS_CANONICAL_GRAPH_GENERATOR_H_
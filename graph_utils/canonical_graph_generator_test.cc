@@ -7,10 +7,12 @@
 
 #include <algorithm>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "graph.h"
+#include "graph_store.h"
 #include "graph_utilities.h"
 #include "gtest/gtest.h"
 #include "nauty_utils/nauty_wrapper.h"
@@ -48,6 +50,18 @@ public:
   }
 };
 
+// The diamond-free filter, without telling the generator that its subsets
+// are hereditary.
+class NonHereditaryDiamondFree : public CanonicalGraphFilter {
+public:
+  virtual bool IsSubsetSafe(const Graph &g, const vector<int> &subset) const {
+    return filter_.IsSubsetSafe(g, subset);
+  }
+
+private:
+  DiamondFreeGraph filter_;
+};
+
 } // namespace
 
 class CanonicalGraphGeneratorTest : public testing::Test {
@@ -56,6 +70,13 @@ protected:
   std::unique_ptr<CanonicalGraphFilter> filter_;
 };
 
+TEST_F(CanonicalGraphGeneratorTest, OrderTooLarge) {
+  // The subsets of the graphs of order 64 no longer fit a SubsetMask.
+  CanonicalGraphGenerator largest(kSubsetMaskSize, filter_.get());
+  ASSERT_THROW(CanonicalGraphGenerator(kSubsetMaskSize + 1, filter_.get()),
+               std::invalid_argument);
+}
+
 TEST_F(CanonicalGraphGeneratorTest, UpperObjects_EmptyGraphTest) {
   vector<string> v({"000", "000", "000"});
   Graph g(v);
@@ -143,6 +164,65 @@ TEST_F(CanonicalGraphGeneratorTest, UpperObjects_LineGraphTest) {
   }
 }
 
+TEST_F(CanonicalGraphGeneratorTest, UpperObjectsUpToAutomorphism) {
+  {
+    // All subsets of the same size are in one orbit.
+    vector<string> v({"000", "000", "000"});
+    Graph g(v);
+    CanonicalGraphGenerator generator(g.size(), filter_.get());
+    vector<Graph *> upper_obj;
+    generator.GenerateUpperObjectsUpToAutomorphism(g, &upper_obj);
+    ASSERT_EQ(3, upper_obj.size());
+  }
+  {
+    // The reflection of the path maps {2} to {0} and {1, 2} to {0, 1}.
+    vector<string> v({"010", "101", "010"});
+    Graph g(v);
+    CanonicalGraphGenerator generator(g.size(), filter_.get());
+    vector<Graph *> all;
+    generator.GenerateUpperObjects(g, &all);
+    vector<Graph *> upper_obj;
+    generator.GenerateUpperObjectsUpToAutomorphism(g, &upper_obj);
+    ASSERT_EQ(4, upper_obj.size());
+    EXPECT_TRUE(PackedGraph(*all[0]) == PackedGraph(*upper_obj[0]));
+    EXPECT_TRUE(PackedGraph(*all[1]) == PackedGraph(*upper_obj[1]));
+    EXPECT_TRUE(PackedGraph(*all[2]) == PackedGraph(*upper_obj[2]));
+    EXPECT_TRUE(PackedGraph(*all[4]) == PackedGraph(*upper_obj[3]));
+  }
+}
+
+TEST(SubsetOrbitsTest, SmallestInOrbit) {
+  // The transposition (0 1) and the cycle (0 1 2 3 4) generate the symmetric
+  // group, under which the subsets of a size form one orbit.
+  vector<vector<int> > generators({{1, 0, 2, 3, 4}, {1, 2, 3, 4, 0}});
+  SubsetOrbits orbits(generators);
+  vector<SubsetMask> smallest;
+  for (SubsetMask mask = 1; mask < 32; ++mask) {
+    if (orbits.IsSmallestInOrbit(mask)) {
+      smallest.push_back(mask);
+    }
+  }
+  ExpectVectorsEq<SubsetMask>({0x01, 0x03, 0x07, 0x0f, 0x1f}, smallest);
+}
+
+TEST_F(CanonicalGraphGeneratorTest, UpperObjects_Backtracking) {
+  // A 5-cycle with a pendant vertex, and an isolated vertex.
+  vector<string> v({"0100110", "1010000", "0101000", "0010100", "1001000",
+                    "1000000", "0000000"});
+  Graph g(v);
+  CanonicalGraphGenerator backtracking(g.size(), filter_.get());
+  NonHereditaryDiamondFree non_hereditary;
+  CanonicalGraphGenerator counting(g.size(), &non_hereditary);
+  vector<Graph *> expected;
+  counting.GenerateUpperObjects(g, &expected);
+  vector<Graph *> upper_obj;
+  backtracking.GenerateUpperObjects(g, &upper_obj);
+  ASSERT_EQ(expected.size(), upper_obj.size());
+  for (size_t i = 0; i < upper_obj.size(); ++i) {
+    EXPECT_TRUE(PackedGraph(*expected[i]) == PackedGraph(*upper_obj[i]));
+  }
+}
+
 TEST_F(CanonicalGraphGeneratorTest, LowerObjectsTest) {
   vector<string> v({"0100", "1011", "0101", "0110"});
   Graph g(v);
@@ -207,4 +287,103 @@ TEST_F(CanonicalGraphGeneratorTest, CompleteGeneration) {
   }
 }
 
+TEST_F(CanonicalGraphGeneratorTest, MultiThreadedGeneration) {
+  filter_.reset(new AllGrapsAcceptable());
+  GraphStore single(7);
+  {
+    CanonicalGraphGenerator generator(7, filter_.get());
+    generator.GenerateGraphs(&single);
+  }
+  for (int num_threads = 2; num_threads <= 5; num_threads += 3) {
+    CanonicalGraphGenerator generator(7, filter_.get());
+    generator.set_num_threads(num_threads);
+    GraphStore multi(7);
+    generator.GenerateGraphs(&multi);
+    // There are 853 connected graphs of order 7.
+    ASSERT_EQ(853, multi.size());
+    ASSERT_EQ(single.size(), multi.size());
+    for (size_t i = 0; i < multi.size(); ++i) {
+      EXPECT_TRUE(std::equal(single.GetRows(i), single.GetRows(i) + 7,
+                             multi.GetRows(i)));
+    }
+  }
+}
+
+TEST_F(CanonicalGraphGeneratorTest, CanonicalDeletion) {
+  CanonicalGraphGenerator generator(4, filter_.get());
+  // A diamond whose last vertex is one of the two of degree 3, which are in
+  // one orbit.
+  vector<string> diamond({"0101", "1011", "0101", "1110"});
+  EXPECT_TRUE(generator.IsCanonicalDeletion(Graph(diamond)));
+  // A triangle with the pendant vertex last, whose degree is too small.
+  vector<string> pendant({"0110", "1010", "1101", "0010"});
+  EXPECT_FALSE(generator.IsCanonicalDeletion(Graph(pendant)));
+  // A star with its centre last, which is a cut vertex.
+  vector<string> star({"0001", "0001", "0001", "1110"});
+  EXPECT_FALSE(generator.IsCanonicalDeletion(Graph(star)));
+  // A path with an end last, in the orbit of the other end.
+  vector<string> path({"0100", "1010", "0101", "0010"});
+  EXPECT_TRUE(generator.IsCanonicalDeletion(Graph(path)));
+
+  // Both modes give the same graphs in the same order, single or
+  // multi-threaded.
+  filter_.reset(new AllGrapsAcceptable());
+  GraphStore expected(7);
+  {
+    CanonicalGraphGenerator generator(7, filter_.get());
+    generator.GenerateGraphs(&expected);
+  }
+  for (int num_threads = 1; num_threads <= 3; num_threads += 2) {
+    CanonicalGraphGenerator generator(7, filter_.get());
+    generator.set_num_threads(num_threads);
+    generator.set_deduplication(CanonicalGraphGenerator::kCanonicalDeletion);
+    GraphStore graphs(7);
+    generator.GenerateGraphs(&graphs);
+    ASSERT_EQ(853, graphs.size());
+    ASSERT_EQ(expected.size(), graphs.size());
+    for (size_t i = 0; i < graphs.size(); ++i) {
+      EXPECT_TRUE(std::equal(expected.GetRows(i), expected.GetRows(i) + 7,
+                             graphs.GetRows(i)));
+    }
+  }
+  {
+    // Same with a hereditary filter.
+    DiamondFreeGraph diamond_free;
+    BasicCanonicalGraphGenerator<DiamondFreeGraph> store(8, &diamond_free);
+    BasicCanonicalGraphGenerator<DiamondFreeGraph> deletion(8, &diamond_free);
+    deletion.set_deduplication(
+        BasicCanonicalGraphGenerator<DiamondFreeGraph>::kCanonicalDeletion);
+    GraphStore expected_graphs(8);
+    GraphStore graphs(8);
+    store.GenerateGraphs(&expected_graphs);
+    deletion.GenerateGraphs(&graphs);
+    ASSERT_EQ(expected_graphs.size(), graphs.size());
+    for (size_t i = 0; i < graphs.size(); ++i) {
+      EXPECT_TRUE(std::equal(expected_graphs.GetRows(i),
+                             expected_graphs.GetRows(i) + 8,
+                             graphs.GetRows(i)));
+    }
+  }
+}
+
+TEST_F(CanonicalGraphGeneratorTest, DepthFirstGeneration) {
+  filter_.reset(new AllGrapsAcceptable());
+  GraphStore expected(7);
+  {
+    CanonicalGraphGenerator generator(7, filter_.get());
+    generator.GenerateGraphs(&expected);
+  }
+  CanonicalGraphGenerator generator(7, filter_.get());
+  std::vector<PackedGraph> forms;
+  const size_t count = generator.GenerateGraphsDepthFirst(
+      [&forms](const Graph &g) { forms.push_back(PackedGraph(g)); });
+  EXPECT_EQ(853, count);
+  // The same canonical forms, in another order.
+  ASSERT_EQ(expected.size(), forms.size());
+  std::sort(forms.begin(), forms.end());
+  for (size_t i = 0; i < forms.size(); ++i) {
+    EXPECT_TRUE(forms[i] == PackedGraph(expected[i]));
+  }
+}
+
 } // namespace graph_utils
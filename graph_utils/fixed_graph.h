@@ -0,0 +1,119 @@
+// A simple graph of an order known at compile time. The adjacency matrix is
+// kept inline as N words (one per vertex), so a FixedGraph lives on the stack,
+// needs no allocation and is copied with a plain memcpy. It offers the same
+// word-level interface as Graph, so the filters and generators can be
+// instantiated with either of them.
+
+#ifndef GRAPH_UTILS_FIXED_GRAPH_H_
+#define GRAPH_UTILS_FIXED_GRAPH_H_
+
+#include <string>
+#include <vector>
+
+#include "bit_utils.h"
+#include "graph.h"
+
+namespace graph_utils {
+
+// The largest order for which a fixed graph fits one word per row.
+const int kMaxFixedGraphOrder = kWordSize;
+
+template <int N> class FixedGraph {
+  static_assert(N > 0 && N <= kMaxFixedGraphOrder,
+                "A FixedGraph must have between 1 and 64 vertices.");
+
+public:
+  FixedGraph() { EmptySet(rows_, N); }
+
+  // Copies the edges of 'g', which must be of order N.
+  explicit FixedGraph(const Graph &g) {
+    for (int v = 0; v < N; ++v) {
+      rows_[v] = g.GetRow(v)[0];
+    }
+  }
+
+  void AddEdge(const int v1, const int v2) {
+    rows_[v1] |= BitMask(v2);
+    rows_[v2] |= BitMask(v1);
+  }
+
+  void RemoveEdge(const int v1, const int v2) {
+    rows_[v1] &= ~BitMask(v2);
+    rows_[v2] &= ~BitMask(v1);
+  }
+
+  bool HasEdge(const int v1, const int v2) const {
+    return (rows_[v1] & BitMask(v2)) != 0;
+  }
+
+  int size() const { return N; }
+
+  const Word *GetRow(const int v) const { return &rows_[v]; }
+  int words_per_row() const { return 1; }
+
+  int CountCommonNeighbours(const int v1, const int v2) const {
+    return PopCount(rows_[v1] & rows_[v2]);
+  }
+
+  int Degree(const int v) const { return PopCount(rows_[v]); }
+
+  int GetNumberOfEdges() const { return SetSize(rows_, N) / 2; }
+
+  bool IsConnected() const {
+    Word reached = BitMask(0);
+    Word frontier = reached;
+    while (frontier) {
+      Word next = 0;
+      for (Word f = frontier; f;) {
+        next |= rows_[TakeFirstBit(&f)];
+      }
+      frontier = next & ~reached;
+      reached |= frontier;
+    }
+    return PopCount(reached) == N;
+  }
+
+  void GetAdjMatrix(std::vector<std::string> *v) const {
+    Graph(N, rows_).GetAdjMatrix(v);
+  }
+
+private:
+  Word rows_[N];
+};
+
+namespace internal {
+
+template <int N> struct FixedGraphDispatcher {
+  template <typename Function>
+  static bool Dispatch(const int n, Function *function) {
+    if (n == N) {
+      function->template Run<N>();
+      return true;
+    }
+    return FixedGraphDispatcher<N - 1>::Dispatch(n, function);
+  }
+};
+
+template <> struct FixedGraphDispatcher<0> {
+  template <typename Function>
+  static bool Dispatch(const int n, Function *function) {
+    return false;
+  }
+};
+
+} // namespace internal
+
+// Calls 'function->Run<N>()' for the FixedGraph order N equal to 'n', which is
+// only known at run time. 'Function' must have a member template
+//   template <int N> void Run();
+// Returns false, without calling anything, if 'n' is out of the range of
+// orders supported by FixedGraph.
+template <typename Function>
+bool DispatchFixedGraphOrder(const int n, Function *function) {
+  return internal::FixedGraphDispatcher<kMaxFixedGraphOrder>::Dispatch(
+      n, function);
+}
+
+} // namespace graph_utils
+
+#endif // GRAPH_UTILS_FIXED_GRAPH_H_
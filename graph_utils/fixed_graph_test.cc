@@ -0,0 +1,159 @@
+// Unit tests for FixedGraph and the generators and filters instantiated with
+// it.
+
+#include "fixed_graph.h"
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "girth_5_graph.h"
+#include "graph.h"
+#include "graph_generator.h"
+#include "graph_utilities.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using std::vector;
+
+namespace graph_utils {
+namespace {
+
+static_assert(std::is_trivially_copyable<FixedGraph<8>>::value,
+              "FixedGraph must be copyable with memcpy.");
+
+void ExpectVectorsEq(const vector<string> &v1, const vector<string> &v2) {
+  ASSERT_EQ(v1.size(), v2.size());
+  for (uint i = 0; i < v1.size(); ++i) {
+    EXPECT_EQ(v1[i], v2[i]);
+  }
+}
+
+class OrderRecorder {
+public:
+  OrderRecorder() : order_(0) {}
+  template <int N> void Run() { order_ = FixedGraph<N>().size(); }
+  int order() const { return order_; }
+
+private:
+  int order_;
+};
+
+} // namespace
+
+TEST(FixedGraphTest, AddAndRemoveEdges) {
+  FixedGraph<4> g;
+  EXPECT_EQ(4, g.size());
+  EXPECT_EQ(0, g.GetNumberOfEdges());
+  g.AddEdge(0, 1);
+  g.AddEdge(0, 3);
+  EXPECT_TRUE(g.HasEdge(0, 1) && g.HasEdge(1, 0));
+  EXPECT_TRUE(g.HasEdge(0, 3) && g.HasEdge(3, 0));
+  EXPECT_FALSE(g.HasEdge(1, 3));
+  EXPECT_EQ(2, g.GetNumberOfEdges());
+  EXPECT_EQ(2, g.Degree(0));
+  EXPECT_EQ(0, g.Degree(2));
+  g.RemoveEdge(1, 0);
+  EXPECT_FALSE(g.HasEdge(0, 1));
+  EXPECT_EQ(1, g.GetNumberOfEdges());
+}
+
+TEST(FixedGraphTest, ConversionToAndFromGraph) {
+  vector<string> v({"0101", "1010", "0100", "1000"});
+  Graph g(v);
+  FixedGraph<4> fixed(g);
+  vector<string> result;
+  fixed.GetAdjMatrix(&result);
+  ExpectVectorsEq(v, result);
+
+  // Copies are independent of each other.
+  FixedGraph<4> copy = fixed;
+  copy.AddEdge(2, 3);
+  EXPECT_TRUE(copy.HasEdge(2, 3));
+  EXPECT_FALSE(fixed.HasEdge(2, 3));
+}
+
+TEST(FixedGraphTest, Connected) {
+  FixedGraph<4> g;
+  EXPECT_FALSE(g.IsConnected());
+  g.AddEdge(0, 1);
+  g.AddEdge(2, 3);
+  EXPECT_FALSE(g.IsConnected());
+  g.AddEdge(1, 3);
+  EXPECT_TRUE(g.IsConnected());
+  EXPECT_EQ(1, g.CountCommonNeighbours(1, 2));
+  EXPECT_EQ(0, g.CountCommonNeighbours(0, 2));
+}
+
+TEST(FixedGraphTest, LargestOrder) {
+  FixedGraph<64> g;
+  for (int i = 0; i < 63; ++i) {
+    g.AddEdge(i, i + 1);
+  }
+  EXPECT_TRUE(g.IsConnected());
+  EXPECT_TRUE(g.HasEdge(63, 62));
+  EXPECT_EQ(63, g.GetNumberOfEdges());
+}
+
+TEST(FixedGraphTest, Filters) {
+  DiamondFreeGraph diamond_filter;
+  Girth5Graph girth_5_filter;
+  GirthNGraph girth_4_filter(4);
+  {
+    // A diamond, which is also a graph of girth 3.
+    Graph g(vector<string>({"0111", "1001", "1001", "1110"}));
+    FixedGraph<4> fixed(g);
+    EXPECT_FALSE(DiamondFreeGraph::IsDiamondFree(fixed));
+    EXPECT_FALSE(diamond_filter.IsNewGraphAcceptable(0, fixed));
+    EXPECT_FALSE(girth_5_filter.IsGirth5Graph(fixed));
+    EXPECT_FALSE(girth_4_filter.IsGirthNGraph(fixed));
+  }
+  {
+    // A cycle of length 5.
+    Graph g(vector<string>({"01001", "10100", "01010", "00101", "10010"}));
+    FixedGraph<5> fixed(g);
+    EXPECT_TRUE(DiamondFreeGraph::IsDiamondFree(fixed));
+    EXPECT_TRUE(girth_5_filter.IsGirth5Graph(fixed));
+    EXPECT_TRUE(girth_4_filter.IsGirthNGraph(fixed));
+    vector<int> adj = {2};
+    EXPECT_TRUE(girth_5_filter.IsNewGraphAcceptable(1, adj, fixed));
+  }
+}
+
+TEST(FixedGraphTest, DispatchOrder) {
+  OrderRecorder recorder;
+  EXPECT_TRUE(DispatchFixedGraphOrder(1, &recorder));
+  EXPECT_EQ(1, recorder.order());
+  EXPECT_TRUE(DispatchFixedGraphOrder(17, &recorder));
+  EXPECT_EQ(17, recorder.order());
+  EXPECT_TRUE(DispatchFixedGraphOrder(64, &recorder));
+  EXPECT_EQ(64, recorder.order());
+  EXPECT_FALSE(DispatchFixedGraphOrder(65, &recorder));
+  EXPECT_FALSE(DispatchFixedGraphOrder(0, &recorder));
+  EXPECT_EQ(64, recorder.order());
+}
+
+TEST(FixedGraphTest, GeneratorMatchesGraphGenerator) {
+  DiamondFreeGraph filter;
+  vector<vector<int>> seqs;
+  SimpleGraphGenerator::GenerateAllDegreeSequences(6, &seqs);
+  for (size_t i = 0; i < seqs.size(); ++i) {
+    vector<Graph *> expected;
+    vector<Graph *> result;
+    SimpleGraphGenerator::GenerateAllUniqueGraphs(seqs[i], &filter, &expected);
+    SimpleGraphGenerator::GenerateAllUniqueFixedGraphs<6>(seqs[i], filter,
+                                                          &result);
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t j = 0; j < result.size(); ++j) {
+      vector<string> expected_matrix;
+      vector<string> result_matrix;
+      expected[j]->GetAdjMatrix(&expected_matrix);
+      result[j]->GetAdjMatrix(&result_matrix);
+      ExpectVectorsEq(expected_matrix, result_matrix);
+      delete expected[j];
+      delete result[j];
+    }
+  }
+}
+
+} // namespace graph_utils
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "bit_utils.h"
 #include "graph.h"
 #include "graph_utilities.h"
 
@@ -12,54 +13,387 @@ namespace graph_utils {
 
 // Girth 5 graph filter, which extends CanonicalGrapgFilter and implements
 // GraphFilter could be used with both the brute-force graph generator and the
-// canonical graph generator.
-class Girth5Graph : public CanonicalGraphFilter, public GraphFilter {
+// canonical graph generator. As with DiamondFreeGraph, the checks are
+// templates for any graph type with the interface of Graph and the virtual
+// methods are inline adapters, which templated generators bind statically.
+class Girth5Graph final : public CanonicalGraphFilter, public GraphFilter {
 public:
   Girth5Graph(){};
   virtual ~Girth5Graph() {}
 
   // Override abstract method from CanonicalGraphFilter.
-  virtual bool IsSubsetSafe(const Graph &g, const vector<int> &subset) const;
+  virtual bool IsSubsetSafe(const Graph &g, const vector<int> &subset) const {
+    return IsSubsetSafe<Graph>(g, subset);
+  }
+  virtual bool IsSubsetSafe(const Graph &g, const SubsetMask subset) const {
+    return IsSubsetSafe<Graph>(g, subset);
+  }
+  virtual bool HasHereditarySubsets() const { return true; }
+  virtual bool IsSubsetExtensionSafe(const Graph &g, const SubsetMask subset,
+                                     const int v) const {
+    return IsSubsetExtensionSafe<Graph>(g, subset, v);
+  }
 
   // Implement the two methods from GraphFilter interface.
-  virtual bool IsNewGraphAcceptable(const int cur_vertex, const Graph &g) const;
+  virtual bool IsNewGraphAcceptable(const int cur_vertex,
+                                    const Graph &g) const {
+    return IsNewGraphAcceptable<Graph>(cur_vertex, g);
+  }
 
   virtual bool IsNewGraphAcceptable(const int cur_vertex,
                                     const vector<int> &new_adj_vertices,
-                                    const Graph &g) const;
+                                    const Graph &g) const {
+    return IsNewGraphAcceptable<Graph>(cur_vertex, new_adj_vertices, g);
+  }
+
+  template <typename GraphType>
+  bool IsSubsetSafe(const GraphType &g, const vector<int> &subset) const;
+  template <typename GraphType>
+  bool IsSubsetSafe(const GraphType &g, const SubsetMask subset) const;
+  template <typename GraphType>
+  bool IsSubsetExtensionSafe(const GraphType &g, const SubsetMask subset,
+                             const int v) const;
+
+  template <typename GraphType>
+  bool IsNewGraphAcceptable(const int cur_vertex, const GraphType &g) const;
+
+  template <typename GraphType>
+  bool IsNewGraphAcceptable(const int cur_vertex,
+                            const vector<int> &new_adj_vertices,
+                            const GraphType &g) const;
 
   // Returns true if a the graph 'g' is of girth 5 (i.e. there are not 3- and 4-
   // cycles).
-  bool IsGirth5Graph(const Graph &g) const;
+  template <typename GraphType> bool IsGirth5Graph(const GraphType &g) const;
+
+private:
+  // Same as IsSubsetSafe() for the subset given as a set of
+  // g.words_per_row() words.
+  template <typename GraphType>
+  bool IsSubsetSetSafe(const GraphType &g, const Word *subset_set) const;
 };
 
 // Generic filter for graphs of any girth.
-class GirthNGraph : public CanonicalGraphFilter, public GraphFilter {
+class GirthNGraph final : public CanonicalGraphFilter, public GraphFilter {
 public:
   explicit GirthNGraph(int girth) { girth_ = girth; };
   virtual ~GirthNGraph() {}
 
   // Override abstract method from CanonicalGraphFilter.
   virtual bool IsSubsetSafe(const Graph &g, const vector<int> &subset) const;
+  virtual bool IsSubsetSafe(const Graph &g, const SubsetMask subset) const;
+  // A new vertex that closes no short cycle with a subset closes none with
+  // any part of it.
+  virtual bool HasHereditarySubsets() const { return true; }
+  virtual bool IsSubsetExtensionSafe(const Graph &g, const SubsetMask subset,
+                                     const int v) const;
+
+  // Same as the above for any graph type. 'g' is assumed to be of girth at
+  // least 'girth' when a subset is extended, so only the cycles through the
+  // new vertex and 'v' are looked for.
+  template <typename GraphType>
+  bool IsSubsetExtensionSafe(const GraphType &g, const SubsetMask subset,
+                             const int v) const;
 
   // Implement the two methods from GraphFilter interface.
-  virtual bool IsNewGraphAcceptable(const int cur_vertex, const Graph &g) const;
+  virtual bool IsNewGraphAcceptable(const int cur_vertex,
+                                    const Graph &g) const {
+    return IsNewGraphAcceptable<Graph>(cur_vertex, g);
+  }
 
   virtual bool IsNewGraphAcceptable(const int cur_vertex,
                                     const vector<int> &new_adj_vertices,
-                                    const Graph &g) const;
+                                    const Graph &g) const {
+    return IsNewGraphAcceptable<Graph>(cur_vertex, new_adj_vertices, g);
+  }
+
+  template <typename GraphType>
+  bool IsNewGraphAcceptable(const int cur_vertex, const GraphType &g) const;
+
+  template <typename GraphType>
+  bool IsNewGraphAcceptable(const int cur_vertex,
+                            const vector<int> &new_adj_vertices,
+                            const GraphType &g) const;
 
+  // Returns false if there is a cycle shorter than 'girth' through (or close
+  // to) 'cur_vertex'.
   static bool IsNewGraphAcceptable(const int cur_vertex, const Graph &g,
+                                   const int girth) {
+    return IsNewGraphAcceptable<Graph>(cur_vertex, g, girth);
+  }
+
+  template <typename GraphType>
+  static bool IsNewGraphAcceptable(const int cur_vertex, const GraphType &g,
                                    const int girth);
 
   // Returns true if a the graph 'g' is of girth at least the given one (i.e.
   // the shortest cycle of the graph is of length at least 'girth').
-  bool IsGirthNGraph(const Graph &g) const;
+  template <typename GraphType> bool IsGirthNGraph(const GraphType &g) const;
 
 private:
+  // Same as IsSubsetSafe() for the subset given as a set of
+  // g.words_per_row() words: the search of IsNewGraphAcceptable() from a new
+  // vertex joined to the subset, without adding the vertex to 'g'.
+  template <typename GraphType>
+  bool IsSubsetSetSafe(const GraphType &g, const Word *subset_set) const;
+
+  // Continues the breadth-first search of IsNewGraphAcceptable() from layer
+  // 'depth', the vertices of 'layer', where 'visited' holds the vertices of
+  // all layers so far. Both sets are of g.words_per_row() words and change.
+  template <typename GraphType>
+  static bool HasNoShortCycleFromLayer(const GraphType &g, int depth,
+                                       Word *visited, Word *layer,
+                                       const int girth);
+
   int girth_;
 };
 
+//////////////////////// Implementation of girth 5 /////////////////////////////
+template <typename GraphType>
+bool Girth5Graph::IsSubsetSafe(const GraphType &g,
+                               const vector<int> &subset) const {
+  WordSet subset_set(g.words_per_row());
+  for (size_t i = 0; i < subset.size(); ++i) {
+    AddElement(subset_set.data(), subset[i]);
+  }
+  return IsSubsetSetSafe(g, subset_set.data());
+}
+
+template <typename GraphType>
+bool Girth5Graph::IsSubsetSafe(const GraphType &g,
+                               const SubsetMask subset) const {
+  WordSet subset_set(g.words_per_row());
+  SubsetMaskToSet(subset, subset_set.data(), g.words_per_row());
+  return IsSubsetSetSafe(g, subset_set.data());
+}
+
+// A subset is safe if it is independent (no triangle) and no two of its
+// vertices have a common neighbour (no square). Both are conditions on pairs,
+// so only the pairs with 'v' need to be checked.
+template <typename GraphType>
+bool Girth5Graph::IsSubsetExtensionSafe(const GraphType &g,
+                                        const SubsetMask subset,
+                                        const int v) const {
+  const int m = g.words_per_row();
+  const Word *v_row = g.GetRow(v);
+  for (SubsetMask rest = subset; rest != 0;) {
+    const int u = TakeSubsetVertex(&rest);
+    if (IsElement(v_row, u)) {
+      return false; // triangle.
+    }
+    if (Intersects(v_row, g.GetRow(u), m)) {
+      return false; // square.
+    }
+  }
+  return true;
+}
+
+template <typename GraphType>
+bool Girth5Graph::IsSubsetSetSafe(const GraphType &g,
+                                  const Word *subset_set) const {
+  const int m = g.words_per_row();
+  // Union of the neighbourhoods of the subset vertices seen so far.
+  WordSet neighbours(m);
+  for (int u = NextElement(subset_set, m, -1); u >= 0;
+       u = NextElement(subset_set, m, u)) {
+    const Word *row = g.GetRow(u);
+    if (Intersects(row, subset_set, m)) {
+      return false; // triangle;
+    }
+    if (Intersects(row, neighbours.data(), m)) {
+      return false; // square.
+    }
+    for (int w = 0; w < m; ++w) {
+      neighbours[w] |= row[w];
+    }
+  }
+  return true;
+}
+
+template <typename GraphType>
+bool Girth5Graph::IsNewGraphAcceptable(const int cur_vertex,
+                                       const GraphType &g) const {
+  return GirthNGraph::IsNewGraphAcceptable<GraphType>(cur_vertex, g, 5);
+}
+
+template <typename GraphType>
+bool Girth5Graph::IsNewGraphAcceptable(const int cur_vertex,
+                                       const vector<int> &new_adj_vertices,
+                                       const GraphType &g) const {
+  const int m = g.words_per_row();
+  const Word *cur_row = g.GetRow(cur_vertex);
+  // Check for additional triangles and squares.
+  for (size_t i = 0; i < new_adj_vertices.size(); ++i) {
+    const int a = new_adj_vertices[i];
+    const Word *a_row = g.GetRow(a);
+    for (int b = NextElement(cur_row, m, -1); b >= 0;
+         b = NextElement(cur_row, m, b)) {
+      if (b == a) {
+        continue;
+      }
+      if (g.HasEdge(a, b)) {
+        return false; // Triangle.
+      }
+      // Any c adjacent to both 'a' and 'b' closes the square
+      // cur_vertex - b - c - a.
+      const Word *b_row = g.GetRow(b);
+      for (int w = 0; w < m; ++w) {
+        Word common = a_row[w] & b_row[w];
+        while (common) {
+          const int c = w * kWordSize + TakeFirstBit(&common);
+          if (c != cur_vertex) {
+            return false; // Square (i.e. cycle of length 4)
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template <typename GraphType>
+bool Girth5Graph::IsGirth5Graph(const GraphType &g) const {
+  for (int i = 0; i < g.size(); ++i) {
+    if (!IsNewGraphAcceptable<GraphType>(i, g)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////// Implementation of girth N /////////////////////////////
+template <typename GraphType>
+bool GirthNGraph::IsNewGraphAcceptable(const int cur_vertex,
+                                       const GraphType &g) const {
+  return IsNewGraphAcceptable<GraphType>(cur_vertex, g, girth_);
+}
+
+template <typename GraphType>
+bool GirthNGraph::IsNewGraphAcceptable(const int cur_vertex,
+                                       const vector<int> &new_adj_vertices,
+                                       const GraphType &g) const {
+  return IsNewGraphAcceptable<GraphType>(cur_vertex, g, girth_);
+}
+
+template <typename GraphType>
+bool GirthNGraph::IsNewGraphAcceptable(const int cur_vertex,
+                                       const GraphType &g, const int girth) {
+  const int m = g.words_per_row();
+  WordSet visited(m);
+  WordSet layer(m);
+  AddElement(visited.data(), cur_vertex);
+  AddElement(layer.data(), cur_vertex);
+  return HasNoShortCycleFromLayer(g, 0, visited.data(), layer.data(), girth);
+}
+
+template <typename GraphType>
+bool GirthNGraph::HasNoShortCycleFromLayer(const GraphType &g, int depth,
+                                           Word *visited, Word *layer,
+                                           const int girth) {
+  // A breadth-first search one layer at a time. An edge inside layer d closes
+  // a cycle of length at most 2d + 1 and a vertex with two neighbours in
+  // layer d closes a cycle of length at most 2d + 2.
+  const int m = g.words_per_row();
+  WordSet next_layer(m);
+  WordSet reached_twice(m);
+  for (; 2 * depth + 1 < girth; ++depth) {
+    EmptySet(next_layer.data(), m);
+    EmptySet(reached_twice.data(), m);
+    bool layer_has_edge = false;
+    for (int v = NextElement(layer, m, -1); v >= 0;
+         v = NextElement(layer, m, v)) {
+      const Word *row = g.GetRow(v);
+      for (int w = 0; w < m; ++w) {
+        layer_has_edge |= (row[w] & layer[w]) != 0;
+        const Word forward = row[w] & ~visited[w];
+        reached_twice[w] |= next_layer[w] & forward;
+        next_layer[w] |= forward;
+      }
+    }
+    if (layer_has_edge) {
+      return false; // The graph contains a cycle of length 2 * depth + 1.
+    }
+    if (2 * depth + 2 < girth && SetSize(reached_twice.data(), m) > 0) {
+      return false; // The graph contains a cycle of length 2 * depth + 2.
+    }
+    if (SetSize(next_layer.data(), m) == 0) {
+      break;
+    }
+    for (int w = 0; w < m; ++w) {
+      visited[w] |= next_layer[w];
+      layer[w] = next_layer[w];
+    }
+  }
+  return true;
+}
+
+template <typename GraphType>
+bool GirthNGraph::IsSubsetSetSafe(const GraphType &g,
+                                  const Word *subset_set) const {
+  // Layer 0 is the new vertex, which has no neighbours in its layer and whose
+  // neighbours are the subset, so the search goes on from layer 1. The new
+  // vertex is in no row of 'g', so it need not be in 'visited'.
+  const int m = g.words_per_row();
+  WordSet visited(m);
+  WordSet layer(m);
+  for (int w = 0; w < m; ++w) {
+    visited[w] = subset_set[w];
+    layer[w] = subset_set[w];
+  }
+  return HasNoShortCycleFromLayer(g, 1, visited.data(), layer.data(), girth_);
+}
+
+// Joining the new vertex to 'v' as well closes a cycle of length d + 2 with
+// every vertex of 'subset' at distance d from 'v'. So no vertex of 'subset'
+// may be less than girth - 2 away from 'v'.
+template <typename GraphType>
+bool GirthNGraph::IsSubsetExtensionSafe(const GraphType &g,
+                                        const SubsetMask subset,
+                                        const int v) const {
+  const int m = g.words_per_row();
+  WordSet subset_set(m);
+  SubsetMaskToSet(subset, subset_set.data(), m);
+  WordSet visited(m);
+  WordSet layer(m);
+  WordSet next_layer(m);
+  AddElement(visited.data(), v);
+  AddElement(layer.data(), v);
+  for (int depth = 0; depth + 2 < girth_; ++depth) {
+    if (Intersects(layer.data(), subset_set.data(), m)) {
+      return false; // A cycle of length depth + 2.
+    }
+    if (depth + 3 == girth_) {
+      break;
+    }
+    EmptySet(next_layer.data(), m);
+    for (int u = NextElement(layer.data(), m, -1); u >= 0;
+         u = NextElement(layer.data(), m, u)) {
+      const Word *row = g.GetRow(u);
+      for (int w = 0; w < m; ++w) {
+        next_layer[w] |= row[w] & ~visited[w];
+      }
+    }
+    if (SetSize(next_layer.data(), m) == 0) {
+      break;
+    }
+    for (int w = 0; w < m; ++w) {
+      visited[w] |= next_layer[w];
+      layer[w] = next_layer[w];
+    }
+  }
+  return true;
+}
+
+template <typename GraphType>
+bool GirthNGraph::IsGirthNGraph(const GraphType &g) const {
+  for (int i = 0; i < g.size(); ++i) {
+    if (!IsNewGraphAcceptable<GraphType>(i, g)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace graph_utils
 
 #endif // GRAPH_UTILS_GIRTH_5_GRAPH_
@@ -168,6 +168,73 @@ TEST_F(Girth5GraphTest, CanonicalFilterTest) {
   }
 }
 
+TEST_F(Girth5GraphTest, CanonicalFilterMaskTest) {
+  filter_generic_.reset(new GirthNGraph(5));
+  // A path 0-1-2-3 and a vertex 4 joined to 0.
+  vector<string> seq({"01001", "10100", "01010", "00100", "10000"});
+  Graph g(seq);
+  for (SubsetMask mask = 1; mask < (SubsetMask(1) << g.size()); ++mask) {
+    vector<int> adj;
+    for (int v = 0; v < g.size(); ++v) {
+      if ((mask >> v) & 1) {
+        adj.push_back(v);
+      }
+    }
+    EXPECT_EQ(filter_->IsSubsetSafe(g, adj), filter_->IsSubsetSafe(g, mask));
+    EXPECT_EQ(filter_generic_->IsSubsetSafe(g, adj),
+              filter_generic_->IsSubsetSafe(g, mask));
+  }
+  EXPECT_TRUE(filter_->IsSubsetSafe(g, SubsetMask(0x09)));  // {0, 3}
+  EXPECT_FALSE(filter_->IsSubsetSafe(g, SubsetMask(0x05))); // {0, 2}
+}
+
+TEST_F(Girth5GraphTest, CanonicalFilterExtensionTest) {
+  filter_generic_.reset(new GirthNGraph(5));
+  ASSERT_TRUE(filter_->HasHereditarySubsets());
+  ASSERT_TRUE(filter_generic_->HasHereditarySubsets());
+  // A path 0-1-2-3 and a vertex 4 joined to 0.
+  vector<string> seq({"01001", "10100", "01010", "00100", "10000"});
+  Graph g(seq);
+  for (SubsetMask mask = 0; mask < (SubsetMask(1) << g.size()); ++mask) {
+    if (mask != 0 && !filter_->IsSubsetSafe(g, mask)) {
+      continue;
+    }
+    for (int v = 0; v < g.size(); ++v) {
+      if ((mask >> v) & 1) {
+        continue;
+      }
+      const SubsetMask extended = mask | (SubsetMask(1) << v);
+      EXPECT_EQ(filter_->IsSubsetSafe(g, extended),
+                filter_->IsSubsetExtensionSafe(g, mask, v));
+      EXPECT_EQ(filter_generic_->IsSubsetSafe(g, extended),
+                filter_generic_->IsSubsetExtensionSafe(g, mask, v));
+    }
+  }
+}
+
+TEST_F(Girth5GraphTest, GenericFilterExtensionTest) {
+  // A path 0-1-2-3-4-5-6 and a vertex 7 joined to 3.
+  vector<string> seq({"01000000", "10100000", "01010000", "00101001",
+                      "00010100", "00001010", "00000100", "00010000"});
+  Graph g(seq);
+  for (int girth = 3; girth <= 9; ++girth) {
+    GirthNGraph filter(girth);
+    for (SubsetMask mask = 0; mask < (SubsetMask(1) << g.size()); ++mask) {
+      if (mask != 0 && !filter.IsSubsetSafe(g, mask)) {
+        continue;
+      }
+      for (int v = 0; v < g.size(); ++v) {
+        if ((mask >> v) & 1) {
+          continue;
+        }
+        const SubsetMask extended = mask | (SubsetMask(1) << v);
+        EXPECT_EQ(filter.IsSubsetSafe(g, extended),
+                  filter.IsSubsetExtensionSafe(g, mask, v));
+      }
+    }
+  }
+}
+
 TEST_F(Girth5GraphTest, GenericGirthTest) {
   vector<string> seq({"00101", "00111", "11000", "01000", "11000"});
   // The graph contains a cycle of length 4. Its girth is 4.
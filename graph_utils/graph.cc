@@ -4,111 +4,312 @@
 
 #include <algorithm>
 #include <cstring>
-#include <set>
-#include <queue>
+
+#include "graph_fingerprint.h"
 
 namespace graph_utils {
+namespace {
 
-Graph::Graph(const int n) {
-  size_ = n;
-  adj_matrix_.resize(n * n, false);
+// The depth-first search of Tarjan's algorithm for the cut vertices, from 'v'
+// whose parent in the search tree is 'parent'. 'order' holds the time each
+// vertex was reached, or -1, and 'low' the earliest time reachable from the
+// subtree of each by a single back edge.
+void FindCutVertices(const Graph &g, const int v, const int parent, int *time,
+                     vector<int> *order, vector<int> *low,
+                     vector<bool> *is_cut_vertex) {
+  (*order)[v] = (*low)[v] = (*time)++;
+  int children = 0;
+  const Word *row = g.GetRow(v);
+  for (int u = NextElement(row, g.words_per_row(), -1); u >= 0;
+       u = NextElement(row, g.words_per_row(), u)) {
+    if ((*order)[u] >= 0) {
+      if (u != parent) {
+        (*low)[v] = std::min((*low)[v], (*order)[u]);
+      }
+      continue;
+    }
+    ++children;
+    FindCutVertices(g, u, v, time, order, low, is_cut_vertex);
+    (*low)[v] = std::min((*low)[v], (*low)[u]);
+    // No vertex below u reaches above v, so removing v cuts them off.
+    if (parent >= 0 && (*low)[u] >= (*order)[v]) {
+      (*is_cut_vertex)[v] = true;
+    }
+  }
+  // The root is a cut vertex if the search leaves it more than once.
+  if (parent < 0 && children > 1) {
+    (*is_cut_vertex)[v] = true;
+  }
+}
+
+} // namespace
+
+Graph::Graph(const int n) : owned_storage_(new Word[StorageWords(n)]()) {
+  SetStorage(n, owned_storage_.get());
+  CountDegrees();
 }
 
-Graph::Graph(const Graph &g) {
-  size_ = g.size();
-  adj_matrix_.insert(adj_matrix_.begin(), g.adj_matrix_.begin(),
-                     g.adj_matrix_.end());
+Graph::Graph(const Graph &g)
+    : owned_storage_(new Word[StorageWords(g.size_)]) {
+  SetStorage(g.size_, owned_storage_.get());
+  memcpy(rows_, g.rows_, StorageWords(size_) * sizeof(Word));
+  degree_sum_ = g.degree_sum_;
+  has_fingerprint_ = g.has_fingerprint_;
+  fingerprint_ = g.fingerprint_;
+  canonical_form_key_ = g.canonical_form_key_;
+  canonical_form_ = g.canonical_form_;
 }
 
-Graph::Graph(const vector<string> &adj_matrix) {
+Graph::Graph(const vector<string> &adj_matrix)
+    : owned_storage_(new Word[StorageWords(adj_matrix.size())]()) {
   const int n = adj_matrix.size();
-  size_ = n;
-  adj_matrix_.resize(n * n, false);
-
+  SetStorage(n, owned_storage_.get());
   for (int i = 0; i < n; ++i) {
+    Word *row = &rows_[i * words_per_row_];
     for (int j = 0; j < n; ++j) {
-      adj_matrix_[i * n + j] = adj_matrix[i][j] != '0';
+      if (adj_matrix[i][j] != '0') {
+        AddElement(row, j);
+      }
     }
   }
+  CountDegrees();
+}
+
+Graph::Graph(const int n, const Word *rows)
+    : owned_storage_(new Word[StorageWords(n)]) {
+  SetStorage(n, owned_storage_.get());
+  memcpy(rows_, rows, n * words_per_row_ * sizeof(Word));
+  CountDegrees();
 }
 
-bool Graph::HasEdge(const int v1, const int v2) const {
-  return adj_matrix_[v1 * size_ + v2];
+Graph::Graph(const int n, const Word *rows, Word *storage) {
+  SetStorage(n, storage);
+  if (rows == NULL) {
+    EmptySet(rows_, n * words_per_row_);
+  } else {
+    memcpy(rows_, rows, n * words_per_row_ * sizeof(Word));
+  }
+  CountDegrees();
+}
+
+int Graph::StorageWords(const int n) {
+  const int degree_words =
+      (2 * n * sizeof(int) + sizeof(Word) - 1) / sizeof(Word);
+  return n * WordsNeeded(n) + degree_words;
 }
 
 void Graph::AddEdge(const int v1, const int v2) {
-  adj_matrix_[v1 * size_ + v2] = true;
-  adj_matrix_[v2 * size_ + v1] = true;
+  Word *row1 = &rows_[v1 * words_per_row_];
+  if (!IsElement(row1, v2)) {
+    AddElement(row1, v2);
+    ChangeDegree(v1, 1);
+    InvalidateCache();
+  }
+  Word *row2 = &rows_[v2 * words_per_row_];
+  if (!IsElement(row2, v1)) {
+    AddElement(row2, v1);
+    ChangeDegree(v2, 1);
+  }
 }
 
 void Graph::RemoveEdge(const int v1, const int v2) {
-  adj_matrix_[v1 * size_ + v2] = false;
-  adj_matrix_[v2 * size_ + v1] = false;
+  Word *row1 = &rows_[v1 * words_per_row_];
+  if (IsElement(row1, v2)) {
+    DeleteElement(row1, v2);
+    ChangeDegree(v1, -1);
+    InvalidateCache();
+  }
+  Word *row2 = &rows_[v2 * words_per_row_];
+  if (IsElement(row2, v1)) {
+    DeleteElement(row2, v1);
+    ChangeDegree(v2, -1);
+  }
 }
 
 void Graph::GetAdjMatrix(vector<string> *v) const {
   v->clear();
   for (int i = 0; i < size_; ++i) {
-    string line = "";
-    for (int j = 0; j < size_; ++j) {
-      line += adj_matrix_[i * size_ + j] ? "1" : "0";
+    const Word *row = GetRow(i);
+    string line(size_, '0');
+    for (int j = NextElement(row, words_per_row_, -1); j >= 0;
+         j = NextElement(row, words_per_row_, j)) {
+      line[j] = '1';
     }
     v->push_back(line);
   }
 }
 
-int Graph::size() const { return size_; }
+void Graph::GetCommonNeighbours(const int v1, const int v2,
+                                Word *result) const {
+  const Word *row1 = GetRow(v1);
+  const Word *row2 = GetRow(v2);
+  for (int i = 0; i < words_per_row_; ++i) {
+    result[i] = row1[i] & row2[i];
+  }
+}
 
-bool Graph::IsConnected() const {
-  std::set<int> visited_nodes;
-  std::queue<int> q;
-  q.push(0);
-  while (!q.empty()) {
-    int cur_edge = q.front();
-    q.pop();
-    visited_nodes.insert(cur_edge);
-    for (int neighbour = 0; neighbour < size(); ++neighbour) {
-      if (HasEdge(cur_edge, neighbour) &&
-          visited_nodes.find(neighbour) == visited_nodes.end()) {
-        visited_nodes.insert(neighbour);
-        q.push(neighbour);
-      }
+void Graph::GetNeighbourhoodUnion(const vector<int> &vertices,
+                                  Word *result) const {
+  EmptySet(result, words_per_row_);
+  for (size_t k = 0; k < vertices.size(); ++k) {
+    const Word *row = GetRow(vertices[k]);
+    for (int i = 0; i < words_per_row_; ++i) {
+      result[i] |= row[i];
     }
   }
-  return visited_nodes.size() == (size_t) size();
 }
 
-int Graph::GetNumberOfEdges() const {
+bool Graph::IsConnected() const {
+  if (size_ == 0) {
+    return false;
+  }
+  WordSet component(words_per_row_);
+  GetConnectedComponent(rows_, words_per_row_, 0, component.data());
+  return SetSize(component.data(), words_per_row_) == size_;
+}
+
+int Graph::GetConnectedComponents(vector<int> *labels) const {
+  labels->assign(size_, -1);
+  WordSet component(words_per_row_);
   int count = 0;
-  for (size_t i = 0; i < adj_matrix_.size(); ++i) {
-    if (adj_matrix_[i]) {
-      ++count;
+  for (int v = 0; v < size_; ++v) {
+    if ((*labels)[v] >= 0) {
+      continue;
+    }
+    GetConnectedComponent(rows_, words_per_row_, v, component.data());
+    for (int u = NextElement(component.data(), words_per_row_, -1); u >= 0;
+         u = NextElement(component.data(), words_per_row_, u)) {
+      (*labels)[u] = count;
     }
+    ++count;
   }
-  count /= 2; // Assuming the graph is simple and there are not self edges.
   return count;
 }
 
+void Graph::GetCutVertices(vector<bool> *is_cut_vertex) const {
+  is_cut_vertex->assign(size_, false);
+  vector<int> order(size_, -1);
+  vector<int> low(size_, 0);
+  int time = 0;
+  for (int v = 0; v < size_; ++v) {
+    if (order[v] < 0) {
+      FindCutVertices(*this, v, -1, &time, &order, &low, is_cut_vertex);
+    }
+  }
+}
+
+void GetConnectedComponent(const Word *rows, const int m, const int v,
+                           Word *component) {
+  // The frontier holds the vertices reached in the last step. The union of
+  // their rows gives the next frontier, until no new vertex is reached.
+  WordSet frontier(m);
+  WordSet next(m);
+  EmptySet(component, m);
+  AddElement(component, v);
+  AddElement(frontier.data(), v);
+  bool changed = true;
+  while (changed) {
+    EmptySet(next.data(), m);
+    for (int u = NextElement(frontier.data(), m, -1); u >= 0;
+         u = NextElement(frontier.data(), m, u)) {
+      const Word *row = &rows[u * m];
+      for (int i = 0; i < m; ++i) {
+        next[i] |= row[i];
+      }
+    }
+    changed = false;
+    for (int i = 0; i < m; ++i) {
+      frontier[i] = next[i] & ~component[i];
+      component[i] |= frontier[i];
+      changed |= frontier[i] != 0;
+    }
+  }
+}
+
+uint64_t Graph::GetFingerprint() const {
+  if (!has_fingerprint_) {
+    fingerprint_ = GetGraphFingerprint(*this);
+    has_fingerprint_ = true;
+  }
+  return fingerprint_;
+}
+
+void Graph::CacheCanonicalForm(const uint64_t key,
+                               std::shared_ptr<const PackedGraph> form) const {
+  canonical_form_key_ = key;
+  canonical_form_ = std::move(form);
+}
+
 string Graph::GetDegSeqString() const {
   string result = "";
-  for (size_t i = 0; i < adj_matrix_.size();) {
-    int count = 0;
-    for (int k = 0; k < size_; ++k, ++i) {
-      if (adj_matrix_[i]) {
-        ++count;
-      }
+  for (int i = 0; i < size_; ++i) {
+    if (i > 0) {
+      result += ',';
     }
-    result += std::to_string(count);
+    result += std::to_string(sorted_degrees_[i]);
   }
-  std::sort(result.begin(), result.end());
   return result;
 }
 
 Graph &Graph::operator=(const Graph &g) {
-  size_ = g.size();
-  adj_matrix_.insert(adj_matrix_.begin(), g.adj_matrix_.begin(),
-                     g.adj_matrix_.end());
+  if (this == &g) {
+    return *this;
+  }
+  const int storage_words = StorageWords(g.size_);
+  if (storage_words != StorageWords(size_)) {
+    owned_storage_.reset(new Word[storage_words]);
+    SetStorage(g.size_, owned_storage_.get());
+  } else {
+    // The current storage, owned or not, is large enough.
+    SetStorage(g.size_, rows_);
+  }
+  memcpy(rows_, g.rows_, storage_words * sizeof(Word));
+  degree_sum_ = g.degree_sum_;
+  has_fingerprint_ = g.has_fingerprint_;
+  fingerprint_ = g.fingerprint_;
+  canonical_form_key_ = g.canonical_form_key_;
+  canonical_form_ = g.canonical_form_;
   return *this;
 }
 
+void Graph::SetStorage(const int n, Word *storage) {
+  size_ = n;
+  words_per_row_ = WordsNeeded(n);
+  rows_ = storage;
+  degrees_ = reinterpret_cast<int *>(storage + n * words_per_row_);
+  sorted_degrees_ = degrees_ + n;
+  InvalidateCache();
+}
+
+void Graph::InvalidateCache() {
+  has_fingerprint_ = false;
+  canonical_form_key_ = 0;
+  canonical_form_.reset();
+}
+
+void Graph::CountDegrees() {
+  degree_sum_ = 0;
+  for (int i = 0; i < size_; ++i) {
+    degrees_[i] = SetSize(GetRow(i), words_per_row_);
+    degree_sum_ += degrees_[i];
+  }
+  std::copy(degrees_, degrees_ + size_, sorted_degrees_);
+  std::sort(sorted_degrees_, sorted_degrees_ + size_);
+}
+
+void Graph::ChangeDegree(const int v, const int delta) {
+  // Changing the last (when increasing) or the first (when decreasing) copy of
+  // the old degree keeps the sorted degrees in order.
+  const int old_degree = degrees_[v];
+  if (delta > 0) {
+    *(std::upper_bound(sorted_degrees_, sorted_degrees_ + size_, old_degree) -
+      1) += delta;
+  } else {
+    *std::lower_bound(sorted_degrees_, sorted_degrees_ + size_, old_degree) +=
+        delta;
+  }
+  degrees_[v] += delta;
+  degree_sum_ += delta;
+}
+
 } // namespace graph_utils
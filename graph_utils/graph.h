@@ -2,37 +2,137 @@
 #ifndef GRAPH_UTILS_GRAPH_H_
 #define GRAPH_UTILS_GRAPH_H_
 
+#include <stdint.h>
+
 #include <string>
 #include <vector>
 #include <memory>
 
+#include "bit_utils.h"
+
 using std::string;
 using std::vector;
 
 namespace graph_utils {
 
-class Graph {
+class PackedGraph;
+
+// Graph is a final, non-virtual type, so that calls like HasEdge() inline into
+// the inner loops of the filters and generators.
+class Graph final {
 public:
   explicit Graph(const int n);
   explicit Graph(const Graph &g);
   explicit Graph(const vector<string> &adj_matrix);
-  virtual ~Graph() {}
-
-  virtual void AddEdge(const int v1, const int v2);
-  virtual void RemoveEdge(const int v1, const int v2);
-  virtual bool HasEdge(const int v1, const int v2) const;
-  virtual void GetAdjMatrix(vector<string> *v) const;
-  virtual int size() const;
-  virtual bool IsConnected() const;
-  virtual int GetNumberOfEdges() const;
-  virtual string GetDegSeqString() const;
+  // Creates a graph of order 'n' from its adjacency rows, stored back to back
+  // with WordsNeeded(n) words per row.
+  Graph(const int n, const Word *rows);
+  // Same as above, but the graph is kept in 'storage' of StorageWords(n) words
+  // instead of memory of its own. The graph does not own 'storage', which must
+  // outlive it. If 'rows' is NULL the graph has no edges. Used by GraphArena.
+  Graph(const int n, const Word *rows, Word *storage);
+  ~Graph() {}
+
+  // Returns the number of words needed to keep the adjacency rows and the
+  // degrees of a graph of order 'n'.
+  static int StorageWords(const int n);
+
+  void AddEdge(const int v1, const int v2);
+  void RemoveEdge(const int v1, const int v2);
+  bool HasEdge(const int v1, const int v2) const {
+    return IsElement(GetRow(v1), v2);
+  }
+  void GetAdjMatrix(vector<string> *v) const;
+  int size() const { return size_; }
+  bool IsConnected() const;
+  // Labels every vertex with the index of its connected component, numbered
+  // in order of their smallest vertex, and returns the number of components.
+  int GetConnectedComponents(vector<int> *labels) const;
+  // Sets (*is_cut_vertex)[v] to whether removing v splits the connected
+  // component of v.
+  void GetCutVertices(vector<bool> *is_cut_vertex) const;
+  // The degrees and the number of edges are kept up to date by AddEdge and
+  // RemoveEdge, so the following queries take constant time.
+  int GetNumberOfEdges() const { return degree_sum_ / 2; }
+  int Degree(const int v) const { return degrees_[v]; }
+  // Returns the degrees of all vertices in non-decreasing order.
+  vector<int> GetSortedDegrees() const {
+    return vector<int>(sorted_degrees_, sorted_degrees_ + size_);
+  }
+  // Returns the degrees in non-decreasing order, separated by commas, e.g.
+  // "1,1,10" for the degrees 10, 1 and 1.
+  string GetDegSeqString() const;
   Graph &operator=(const Graph &g);
 
+  // Word-level access to the adjacency matrix. Every row consists of
+  // words_per_row() words and bit 'u' of row 'v' is set iff 'u' and 'v' are
+  // adjacent (see bit_utils.h for the bit layout).
+  const Word *GetRow(const int v) const { return &rows_[v * words_per_row_]; }
+  int words_per_row() const { return words_per_row_; }
+
+  // Returns the number of vertices adjacent to both 'v1' and 'v2'.
+  int CountCommonNeighbours(const int v1, const int v2) const {
+    return IntersectionSize(GetRow(v1), GetRow(v2), words_per_row_);
+  }
+
+  // Stores the set of vertices adjacent to both 'v1' and 'v2' into 'result',
+  // which must hold words_per_row() words.
+  void GetCommonNeighbours(const int v1, const int v2, Word *result) const;
+
+  // Stores the set of vertices adjacent to at least one of 'vertices' into
+  // 'result', which must hold words_per_row() words.
+  void GetNeighbourhoodUnion(const vector<int> &vertices, Word *result) const;
+
+  // The graph caches the invariants below until AddEdge() or RemoveEdge()
+  // changes it, so asking for them again costs nothing. Copies of the graph
+  // share the cache. Because of the cache, these const methods must not be
+  // called on one graph from several threads at once.
+  //
+  // Returns the fingerprint of the graph (see graph_fingerprint.h).
+  uint64_t GetFingerprint() const;
+  // Returns the canonical form cached under 'key', or NULL if there is none.
+  // The forms are computed by nauty_utils, which keys them by the Canonizer
+  // and options that computed them (see IsomorphismChecker::GetCanonicalForm).
+  const PackedGraph *GetCachedCanonicalForm(const uint64_t key) const {
+    return key == canonical_form_key_ ? canonical_form_.get() : NULL;
+  }
+  void CacheCanonicalForm(const uint64_t key,
+                          std::shared_ptr<const PackedGraph> form) const;
+
 private:
+  // Points the rows and the degrees of a graph of order 'n' into 'storage'.
+  // The graph has no cached invariants afterwards.
+  void SetStorage(const int n, Word *storage);
+  // Drops the cached invariants.
+  void InvalidateCache();
+  // Recomputes all degrees from the adjacency rows.
+  void CountDegrees();
+  // Changes the degree of 'v' by 'delta' (either 1 or -1).
+  void ChangeDegree(const int v, const int delta);
+
   int size_;
-  std::vector<bool> adj_matrix_;
+  int words_per_row_;
+  // The adjacency rows followed by the degrees and the sorted degrees, all of
+  // them inside a single block of StorageWords(size_) words. The block is
+  // 'owned_storage_' unless the graph was given its storage at construction.
+  Word *rows_;
+  int *degrees_;
+  int *sorted_degrees_;
+  int degree_sum_;
+  std::unique_ptr<Word[]> owned_storage_;
+  // The cached invariants. A key of 0 means that no form is cached.
+  mutable bool has_fingerprint_;
+  mutable uint64_t fingerprint_;
+  mutable uint64_t canonical_form_key_;
+  mutable std::shared_ptr<const PackedGraph> canonical_form_;
 };
 
+// Stores the vertices of the connected component of 'v' into 'component', for
+// the graph with the given adjacency rows of 'm' words each (laid out as in
+// Graph). 'component' must hold 'm' words.
+void GetConnectedComponent(const Word *rows, const int m, const int v,
+                           Word *component);
+
 } // namespace graph_utils
 
 #endif // GRAPH_UTILS_GRAPH_H_
@@ -0,0 +1,79 @@
+// Implementation of GraphArena.
+
+#include "graph_arena.h"
+
+#include <algorithm>
+#include <new>
+
+#include "graph.h"
+
+namespace graph_utils {
+namespace {
+
+// The number of words taken by a Graph object in front of its storage.
+const size_t kGraphObjectWords =
+    (sizeof(Graph) + sizeof(Word) - 1) / sizeof(Word);
+
+static_assert(alignof(Graph) <= alignof(Word),
+              "Graphs are placed at word boundaries.");
+
+} // namespace
+
+GraphArena::GraphArena(const size_t slab_words)
+    : slab_words_(slab_words), cur_slab_(0), cur_offset_(0) {}
+
+GraphArena::~GraphArena() { Clear(); }
+
+Graph *GraphArena::NewGraph(const int n) { return NewGraph(n, NULL); }
+
+Graph *GraphArena::NewGraph(const int n, const Word *rows) {
+  Entry entry;
+  Word *block = Allocate(kGraphObjectWords + Graph::StorageWords(n),
+                         &entry.slab);
+  entry.graph = new (block) Graph(n, rows, block + kGraphObjectWords);
+  graphs_.push_back(entry);
+  return entry.graph;
+}
+
+Graph *GraphArena::NewGraph(const Graph &g) {
+  // The assignment copies the rows and the degrees as they are, without
+  // counting the degrees again.
+  Graph *copy = NewGraph(g.size());
+  *copy = g;
+  return copy;
+}
+
+void GraphArena::Truncate(const size_t count) {
+  if (count >= graphs_.size()) {
+    return;
+  }
+  for (size_t i = graphs_.size(); i > count; --i) {
+    graphs_[i - 1].graph->~Graph();
+  }
+  // The memory from the first destroyed graph onwards is free again.
+  const Entry &first = graphs_[count];
+  cur_slab_ = first.slab;
+  cur_offset_ =
+      reinterpret_cast<Word *>(first.graph) - slabs_[first.slab].get();
+  graphs_.resize(count);
+}
+
+Word *GraphArena::Allocate(const size_t words, size_t *slab) {
+  while (cur_slab_ < slabs_.size() &&
+         cur_offset_ + words > slab_sizes_[cur_slab_]) {
+    ++cur_slab_;
+    cur_offset_ = 0;
+  }
+  if (cur_slab_ == slabs_.size()) {
+    // Graphs larger than a slab get a slab of their own.
+    const size_t size = std::max(slab_words_, words);
+    slabs_.push_back(std::unique_ptr<Word[]>(new Word[size]));
+    slab_sizes_.push_back(size);
+  }
+  Word *block = slabs_[cur_slab_].get() + cur_offset_;
+  cur_offset_ += words;
+  *slab = cur_slab_;
+  return block;
+}
+
+} // namespace graph_utils
@@ -0,0 +1,77 @@
+// An arena allocator for Graph objects. The generators create and drop a large
+// number of short-lived candidate graphs; an arena places every graph together
+// with its adjacency rows and degrees in large slabs, so that creating a graph
+// costs a bump of an offset and a whole set of graphs (e.g. a level of the
+// canonical construction) is freed with a single call.
+//
+// An arena is not thread safe. Threads generating graphs concurrently should
+// use an arena each.
+
+#ifndef GRAPH_UTILS_GRAPH_ARENA_H_
+#define GRAPH_UTILS_GRAPH_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "bit_utils.h"
+#include "graph.h"
+
+namespace graph_utils {
+
+class GraphArena {
+public:
+  // The default slab holds 512KB, i.e. a few thousand graphs of small order.
+  static const size_t kDefaultSlabWords = 1 << 16;
+
+  explicit GraphArena(const size_t slab_words = kDefaultSlabWords);
+  ~GraphArena();
+
+  // Create graphs owned by the arena, which must not be deleted. They stay
+  // valid until they are destroyed by Truncate() or Clear(), or the arena is.
+  //
+  // Creates a graph of order 'n' without edges.
+  Graph *NewGraph(const int n);
+  // Creates a graph of order 'n' from its adjacency rows (see Graph).
+  Graph *NewGraph(const int n, const Word *rows);
+  // Creates a copy of 'g'.
+  Graph *NewGraph(const Graph &g);
+
+  // Graphs are numbered in the order of their creation. The number of a graph
+  // is its handle within the arena until it is destroyed.
+  size_t size() const { return graphs_.size(); }
+  Graph *operator[](const size_t i) const { return graphs_[i].graph; }
+
+  // Destroys all graphs but the first 'count' ones and reuses their memory.
+  void Truncate(const size_t count);
+
+  // Destroys all graphs. The slabs are kept and reused by the next graphs.
+  void Clear() { Truncate(0); }
+
+private:
+  struct Entry {
+    Graph *graph;
+    // The slab containing the graph.
+    size_t slab;
+  };
+
+  // Returns a block of 'words' words from the current slab, moving on to the
+  // next (or a new) slab if it is full. Stores the slab used into 'slab'.
+  Word *Allocate(const size_t words, size_t *slab);
+
+  GraphArena(const GraphArena &);
+  GraphArena &operator=(const GraphArena &);
+
+  size_t slab_words_;
+  std::vector<std::unique_ptr<Word[]>> slabs_;
+  std::vector<size_t> slab_sizes_;
+  // The slab in use and the offset of its first free word.
+  size_t cur_slab_;
+  size_t cur_offset_;
+  std::vector<Entry> graphs_;
+};
+
+} // namespace graph_utils
+
+#endif // GRAPH_UTILS_GRAPH_ARENA_H_
@@ -0,0 +1,117 @@
+// Unit tests for GraphArena.
+
+#include "graph_arena.h"
+
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using std::vector;
+
+namespace graph_utils {
+namespace {
+
+void ExpectVectorsEq(const vector<string> &v1, const vector<string> &v2) {
+  ASSERT_EQ(v1.size(), v2.size());
+  for (size_t i = 0; i < v1.size(); ++i) {
+    EXPECT_EQ(v1[i], v2[i]);
+  }
+}
+
+} // namespace
+
+TEST(GraphArenaTest, NewGraphs) {
+  GraphArena arena;
+  Graph *empty = arena.NewGraph(3);
+  EXPECT_EQ(3, empty->size());
+  EXPECT_EQ(0, empty->GetNumberOfEdges());
+
+  vector<string> v({"0101", "1010", "0100", "1000"});
+  Graph g(v);
+  Graph *copy = arena.NewGraph(g);
+  Graph *from_rows = arena.NewGraph(g.size(), g.GetRow(0));
+  ASSERT_EQ(3, arena.size());
+  EXPECT_EQ(empty, arena[0]);
+  EXPECT_EQ(copy, arena[1]);
+  EXPECT_EQ(from_rows, arena[2]);
+  vector<string> result;
+  copy->GetAdjMatrix(&result);
+  ExpectVectorsEq(v, result);
+  from_rows->GetAdjMatrix(&result);
+  ExpectVectorsEq(v, result);
+  EXPECT_EQ(2, copy->Degree(0));
+  EXPECT_EQ(vector<int>({1, 1, 2, 2}), from_rows->GetSortedDegrees());
+
+  // Graphs in the arena are independent of each other.
+  copy->AddEdge(2, 3);
+  EXPECT_TRUE(copy->HasEdge(3, 2));
+  EXPECT_FALSE(from_rows->HasEdge(3, 2));
+  EXPECT_FALSE(g.HasEdge(3, 2));
+  EXPECT_EQ(0, empty->GetNumberOfEdges());
+}
+
+TEST(GraphArenaTest, TruncateReusesMemory) {
+  GraphArena arena;
+  Graph *first = arena.NewGraph(5);
+  Graph *second = arena.NewGraph(5);
+  arena.NewGraph(5);
+  arena.Truncate(1);
+  ASSERT_EQ(1, arena.size());
+  EXPECT_EQ(first, arena[0]);
+  // The next graph takes the place of the first destroyed one.
+  Graph *replacement = arena.NewGraph(5);
+  EXPECT_EQ(second, replacement);
+  EXPECT_EQ(0, replacement->GetNumberOfEdges());
+
+  arena.Clear();
+  EXPECT_EQ(0, arena.size());
+  EXPECT_EQ(first, arena.NewGraph(5));
+}
+
+TEST(GraphArenaTest, ManySlabs) {
+  // Slabs of 64 words hold only a few small graphs each, and a graph of order
+  // 100 needs a slab of its own.
+  GraphArena arena(64);
+  vector<Graph *> graphs;
+  for (int i = 0; i < 50; ++i) {
+    Graph *g = arena.NewGraph(6);
+    g->AddEdge(i % 6, (i + 1) % 6);
+    graphs.push_back(g);
+  }
+  Graph *large = arena.NewGraph(100);
+  large->AddEdge(0, 99);
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(1, graphs[i]->GetNumberOfEdges());
+    EXPECT_TRUE(graphs[i]->HasEdge(i % 6, (i + 1) % 6));
+  }
+  EXPECT_TRUE(large->HasEdge(99, 0));
+
+  arena.Truncate(10);
+  for (int i = 0; i < 50; ++i) {
+    arena.NewGraph(6);
+  }
+  EXPECT_EQ(60, arena.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(arena[i]->HasEdge(i % 6, (i + 1) % 6));
+  }
+}
+
+TEST(GraphArenaTest, AssignGraphOfDifferentOrder) {
+  GraphArena arena;
+  Graph *g = arena.NewGraph(3);
+  Graph *next = arena.NewGraph(3);
+  Graph other(70);
+  other.AddEdge(0, 69);
+  // The graph does not fit the storage it got from the arena, so it takes
+  // memory of its own.
+  *g = other;
+  EXPECT_EQ(70, g->size());
+  EXPECT_TRUE(g->HasEdge(69, 0));
+  EXPECT_EQ(3, next->size());
+  EXPECT_EQ(0, next->GetNumberOfEdges());
+}
+
+} // namespace graph_utils
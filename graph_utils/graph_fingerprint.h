@@ -0,0 +1,77 @@
+// A 64-bit fingerprint of a graph, made of invariants under isomorphism:
+// isomorphic graphs always get the same fingerprint, so graphs whose
+// fingerprints differ need not be compared with nauty at all. Different graphs
+// may share a fingerprint, hence equal fingerprints still need a full check.
+//
+// Every vertex gets a signature from its degree, the number of triangles it is
+// on and the multiset of the degrees of its neighbours. The fingerprint hashes
+// the order of the graph together with the sorted signatures. Everything is
+// counted on the adjacency rows with word operations, in O(n * m) for the
+// degrees and O(|E| * m) for the rest, where m is the number of words per row.
+
+#ifndef GRAPH_UTILS_GRAPH_FINGERPRINT_H_
+#define GRAPH_UTILS_GRAPH_FINGERPRINT_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "bit_utils.h"
+
+namespace graph_utils {
+
+// Scrambles the bits of 'x' (the finalizer of SplitMix64), so that sums and
+// sequences of mixed values make good hashes.
+inline uint64_t MixBits(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// Returns the fingerprint of 'g', which may be of any graph type with the
+// word-level interface of Graph (e.g. Graph, FixedGraph and GraphView).
+template <typename GraphType> uint64_t GetGraphFingerprint(const GraphType &g) {
+  const int n = g.size();
+  const int m = g.words_per_row();
+  std::vector<int> degrees(n);
+  for (int v = 0; v < n; ++v) {
+    degrees[v] = SetSize(g.GetRow(v), m);
+  }
+  // Both sums are taken over the edges; every triangle is counted twice at
+  // each of its vertices.
+  std::vector<int> triangles(n, 0);
+  std::vector<uint64_t> neighbour_degrees(n, 0);
+  for (int v = 0; v < n; ++v) {
+    const Word *row = g.GetRow(v);
+    for (int w = WordIndex(v); w < m; ++w) {
+      Word later = w == WordIndex(v) ? row[w] & MaskAfter(v) : row[w];
+      while (later) {
+        const int u = w * kWordSize + TakeFirstBit(&later);
+        const int common = IntersectionSize(row, g.GetRow(u), m);
+        triangles[v] += common;
+        triangles[u] += common;
+        neighbour_degrees[v] += MixBits(degrees[u]);
+        neighbour_degrees[u] += MixBits(degrees[v]);
+      }
+    }
+  }
+  std::vector<uint64_t> signatures(n);
+  for (int v = 0; v < n; ++v) {
+    signatures[v] = MixBits(MixBits(MixBits(degrees[v]) ^ triangles[v]) +
+                            neighbour_degrees[v]);
+  }
+  std::sort(signatures.begin(), signatures.end());
+  uint64_t fingerprint = MixBits(n);
+  for (int v = 0; v < n; ++v) {
+    fingerprint = MixBits(fingerprint ^ signatures[v]);
+  }
+  return fingerprint;
+}
+
+} // namespace graph_utils
+
+#endif // GRAPH_UTILS_GRAPH_FINGERPRINT_H_
@@ -0,0 +1,105 @@
+// Unit tests for GetGraphFingerprint.
+
+#include "graph_fingerprint.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "fixed_graph.h"
+#include "graph.h"
+#include "graph_store.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using std::vector;
+
+namespace graph_utils {
+namespace {
+
+// Stores into 'result' the graph 'g' with its vertices relabelled by
+// 'permutation'.
+void Permute(const Graph &g, const vector<int> &permutation, Graph *result) {
+  *result = Graph(g.size());
+  for (int i = 0; i < g.size(); ++i) {
+    for (int j = i + 1; j < g.size(); ++j) {
+      if (g.HasEdge(i, j)) {
+        result->AddEdge(permutation[i], permutation[j]);
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(GraphFingerprintTest, IsomorphicGraphs) {
+  // A graph of order 80 with edges {i, j} for j - i in {1, 2, 7, 30}.
+  Graph g(80);
+  const int kSteps[] = {1, 2, 7, 30};
+  for (int i = 0; i < 80; ++i) {
+    for (int k = 0; k < 4; ++k) {
+      if (i + kSteps[k] < 80) {
+        g.AddEdge(i, i + kSteps[k]);
+      }
+    }
+  }
+  vector<int> permutation(80);
+  for (int i = 0; i < 80; ++i) {
+    permutation[i] = (i * 37 + 11) % 80;
+  }
+  Graph permuted(1);
+  Permute(g, permutation, &permuted);
+  EXPECT_EQ(GetGraphFingerprint(g), GetGraphFingerprint(permuted));
+  EXPECT_EQ(GetGraphFingerprint(g), GetGraphFingerprint(GraphView(g)));
+
+  g.RemoveEdge(40, 41);
+  EXPECT_NE(GetGraphFingerprint(g), GetGraphFingerprint(permuted));
+}
+
+TEST(GraphFingerprintTest, FixedGraph) {
+  vector<string> v({"0110", "1011", "1100", "0100"});
+  Graph g(v);
+  EXPECT_EQ(GetGraphFingerprint(g), GetGraphFingerprint(FixedGraph<4>(g)));
+}
+
+TEST(GraphFingerprintTest, SameDegreeSequence) {
+  // A cycle of length 6 and two triangles.
+  vector<string> cycle(
+      {"010001", "101000", "010100", "001010", "000101", "100010"});
+  vector<string> triangles(
+      {"011000", "101000", "110000", "000011", "000101", "000110"});
+  EXPECT_NE(GetGraphFingerprint(Graph(cycle)),
+            GetGraphFingerprint(Graph(triangles)));
+
+  // Two trees with three legs from a vertex of degree 3, of lengths 1, 1, 3
+  // and 1, 2, 2. The degrees are the same, the degrees of the neighbours of
+  // the centre are not.
+  vector<string> g1({"010000", "101100", "010010", "010000", "001001",
+                     "000010"});
+  vector<string> g2({"011010", "100000", "100100", "001000", "100001",
+                     "000010"});
+  Graph graph1(g1);
+  Graph graph2(g2);
+  EXPECT_EQ(graph1.GetSortedDegrees(), graph2.GetSortedDegrees());
+  EXPECT_NE(GetGraphFingerprint(graph1), GetGraphFingerprint(graph2));
+}
+
+TEST(GraphFingerprintTest, LargeDegrees) {
+  // Degree sequences, which are told apart only by degrees of 10 or more.
+  Graph g1(24);
+  Graph g2(24);
+  for (int i = 1; i <= 10; ++i) {
+    g1.AddEdge(0, i);
+    g2.AddEdge(0, i);
+  }
+  for (int i = 12; i <= 22; ++i) {
+    g1.AddEdge(11, i);
+  }
+  for (int i = 12; i <= 21; ++i) {
+    g2.AddEdge(11, i);
+  }
+  g2.AddEdge(22, 23);
+  EXPECT_NE(GetGraphFingerprint(g1), GetGraphFingerprint(g2));
+}
+
+} // namespace graph_utils
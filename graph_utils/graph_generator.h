@@ -5,12 +5,17 @@
 #ifndef GRAPH_UTILS_GRAPH_GENERATOR_H_
 #define GRAPH_UTILS_GRAPH_GENERATOR_H_
 
+#include <algorithm>
 #include <set>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "fixed_graph.h"
 #include "graph.h"
+#include "graph_store.h"
 #include "graph_utilities.h"
+#include "nauty_utils/nauty_wrapper.h"
 
 namespace graph_utils {
 
@@ -47,9 +52,32 @@ public:
                                 std::vector<Graph *> *graphs);
 
   // Generates all unique connected graphs with the given degree sequence.
+  // The graphs are either appended to a vector, which takes their ownership,
+  // or to a GraphStore of the order of the sequence.
   static void GenerateAllUniqueGraphs(const std::vector<int> &seq,
                                       GraphFilter *filter,
                                       std::vector<Graph *> *graphs);
+  static void GenerateAllUniqueGraphs(const std::vector<int> &seq,
+                                      GraphFilter *filter, GraphStore *graphs);
+
+  // Same as above, but the checks of the concrete 'FilterType' (e.g.
+  // DiamondFreeGraph) are bound at compile time, so they can be inlined into
+  // the search. Chosen over the GraphFilter overloads whenever the filter is
+  // passed by its own type. 'ResultType' is std::vector<Graph *> or
+  // GraphStore.
+  template <typename FilterType, typename ResultType>
+  static void GenerateAllUniqueGraphs(const std::vector<int> &seq,
+                                      const FilterType *filter,
+                                      ResultType *graphs);
+
+  // Same as above, but the search runs on a FixedGraph<N> kept on the stack
+  // and the checks of the concrete 'FilterType' are resolved at compile time.
+  // The degree sequence must be of length N (see DispatchFixedGraphOrder for
+  // choosing N at run time).
+  template <int N, typename FilterType, typename ResultType>
+  static void GenerateAllUniqueFixedGraphs(const std::vector<int> &seq,
+                                           const FilterType &filter,
+                                           ResultType *graphs);
 
   // Generates all non-increasing degree sequences for n vertices. The generated
   // sequences are not guaranteed to be graphical. Graphicality needs to be
@@ -63,10 +91,20 @@ private:
   // 'unique_graphs_only' is false all graphs are generated without pruning.
   // If it is set to true, the filter is used to prune the search, only
   // connected graphs are added and isomorphic copies are eliminated.
+  template <typename GraphType, typename FilterType, typename ResultType>
   static void GenerateAllGraphs(const std::vector<std::pair<int, int>> &seq,
                                 const bool unique_graphs_only,
-                                GraphFilter *filter, Graph *g,
-                                std::vector<Graph *> *graphs);
+                                const FilterType *filter, GraphType *g,
+                                ResultType *graphs);
+
+  // Adds a copy of the complete graph 'g' to 'graphs', unless
+  // 'unique_graphs_only' is set and there is already a graph isomorphic to it.
+  template <typename GraphType>
+  static void AddGraph(const GraphType &g, const bool unique_graphs_only,
+                       std::vector<Graph *> *graphs);
+  template <typename GraphType>
+  static void AddGraph(const GraphType &g, const bool unique_graphs_only,
+                       GraphStore *graphs);
 
   // A helper function to recursively generate all non-increasing degree
   // sequences of order n.
@@ -74,6 +112,134 @@ private:
                                          std::vector<std::vector<int>> *seqs);
 };
 
+// Generates all graphs for a degree sequence with SimpleGraphGenerator on a
+// FixedGraph of the order of the sequence. Used with DispatchFixedGraphOrder,
+// which picks that order at run time.
+template <typename FilterType> class FixedOrderGenerator {
+public:
+  FixedOrderGenerator(const std::vector<int> &seq, const FilterType &filter,
+                      GraphStore *graphs)
+      : seq_(seq), filter_(filter), graphs_(graphs) {}
+
+  template <int N> void Run() {
+    SimpleGraphGenerator::GenerateAllUniqueFixedGraphs<N>(seq_, filter_,
+                                                          graphs_);
+  }
+
+private:
+  const std::vector<int> &seq_;
+  const FilterType &filter_;
+  GraphStore *graphs_;
+};
+
+template <typename FilterType, typename ResultType>
+void SimpleGraphGenerator::GenerateAllUniqueGraphs(
+    const std::vector<int> &seq, const FilterType *filter,
+    ResultType *graphs) {
+  Graph g(seq.size());
+  std::vector<std::pair<int, int>> new_seq;
+  for (int i = 0; i < (int) seq.size(); ++i) {
+    new_seq.push_back(std::make_pair(seq[i], i));
+  }
+  GenerateAllGraphs(new_seq, true, filter, &g, graphs);
+}
+
+template <int N, typename FilterType, typename ResultType>
+void SimpleGraphGenerator::GenerateAllUniqueFixedGraphs(
+    const std::vector<int> &seq, const FilterType &filter,
+    ResultType *graphs) {
+  if (seq.size() != (size_t) N) {
+    throw std::invalid_argument(
+        "The degree sequence must be as long as the graph order.");
+  }
+  FixedGraph<N> g;
+  std::vector<std::pair<int, int>> new_seq;
+  for (int i = 0; i < N; ++i) {
+    new_seq.push_back(std::make_pair(seq[i], i));
+  }
+  GenerateAllGraphs(new_seq, true, &filter, &g, graphs);
+}
+
+template <typename GraphType>
+void SimpleGraphGenerator::AddGraph(const GraphType &g,
+                                    const bool unique_graphs_only,
+                                    std::vector<Graph *> *graphs) {
+  Graph *result = new Graph(g.size(), g.GetRow(0));
+  if (!unique_graphs_only) {
+    graphs->push_back(result);
+    return;
+  }
+  for (size_t i = 0; i < graphs->size(); ++i) {
+    if (nauty_utils::IsomorphismChecker::AreIsomorphic(*(*graphs)[i],
+                                                       *result)) {
+      delete result;
+      return; // The generated graph is not unique.
+    }
+  }
+  graphs->push_back(result);
+}
+
+template <typename GraphType>
+void SimpleGraphGenerator::AddGraph(const GraphType &g,
+                                    const bool unique_graphs_only,
+                                    GraphStore *graphs) {
+  const GraphView result(g.size(), g.GetRow(0));
+  if (unique_graphs_only) {
+    for (size_t i = 0; i < graphs->size(); ++i) {
+      if (nauty_utils::IsomorphismChecker::AreIsomorphic((*graphs)[i],
+                                                         result)) {
+        return; // The generated graph is not unique.
+      }
+    }
+  }
+  graphs->Append(result);
+}
+
+template <typename GraphType, typename FilterType, typename ResultType>
+void SimpleGraphGenerator::GenerateAllGraphs(
+    const std::vector<std::pair<int, int>> &seq, // [ (deg, vertex), ...]
+    const bool unique_graphs_only, const FilterType *filter, GraphType *g,
+    ResultType *graphs) {
+  if (seq.front().first <= 0) {
+    if (!g->IsConnected()) {
+      return; // We are only interested in connected graphs.
+    }
+    AddGraph(*g, unique_graphs_only, graphs);
+    return;
+  }
+  std::vector<int> helper_seq;
+  for (size_t i = 0; i < seq.size(); ++i) {
+    if (seq[i].first <= 0) {
+      break;
+    }
+    helper_seq.push_back(seq[i].first);
+  }
+  std::set<int> helper_set;
+  std::vector<std::set<int>> adj_sets;
+  GenerateAllAdjSets(helper_seq, &helper_set, &adj_sets);
+  for (size_t i = 0; i < adj_sets.size(); ++i) {
+    const std::set<int> &curr_set = adj_sets[i];
+
+    std::vector<std::pair<int, int>> new_seq(seq);
+    std::vector<int> actual_adj_vertices;
+    new_seq[0].first = 0;
+    for (auto it = curr_set.cbegin(); it != curr_set.cend(); ++it) {
+      g->AddEdge(seq[0].second, seq[*it].second); // Add temporary edges
+      actual_adj_vertices.push_back(seq[*it].second);
+      --new_seq[*it].first; // reduce degree sequence
+    }
+    if (!unique_graphs_only || (unique_graphs_only &&
+                                filter->IsNewGraphAcceptable(
+                                    seq[0].second, actual_adj_vertices, *g))) {
+      std::sort(new_seq.rbegin(), new_seq.rend()); // reverse sort
+      GenerateAllGraphs(new_seq, unique_graphs_only, filter, g, graphs);
+    }
+    for (auto it = curr_set.cbegin(); it != curr_set.cend(); ++it) {
+      g->RemoveEdge(seq[0].second, seq[*it].second); // remove temp edges
+    }
+  }
+}
+
 } // namespace graph_utils
 
 #endif // GRAPH_UTILS_GRAPH_GENERATOR_H_
@@ -210,6 +210,25 @@ TEST_F(SimpleGraphGeneratorTest, GenerateAllUniqueGraphsByDegreeSeq) {
   }
 }
 
+TEST_F(SimpleGraphGeneratorTest, FixedOrderGenerator) {
+  // Both a 6-cycle and two triangles have this sequence; only the cycle is
+  // connected and diamond free.
+  vector<int> seq({2, 2, 2, 2, 2, 2});
+  DiamondFreeGraph filter;
+  GraphStore expected(seq.size());
+  SimpleGraphGenerator::GenerateAllUniqueGraphs(seq, &filter, &expected);
+  GraphStore graphs(seq.size());
+  FixedOrderGenerator<DiamondFreeGraph> generator(seq, filter, &graphs);
+  ASSERT_TRUE(DispatchFixedGraphOrder(seq.size(), &generator));
+  ASSERT_EQ(1, graphs.size());
+  ASSERT_EQ(expected.size(), graphs.size());
+  vector<string> expected_matrix;
+  expected[0].GetAdjMatrix(&expected_matrix);
+  vector<string> matrix;
+  graphs[0].GetAdjMatrix(&matrix);
+  ExpectVectorsEq<string>(expected_matrix, matrix);
+}
+
 TEST_F(SimpleGraphGeneratorTest, GenerateAllDegreeSeqs) {
   {
     vector<vector<int>> seqs;
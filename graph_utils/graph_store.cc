@@ -0,0 +1,64 @@
+// Implementation of GraphStore and GraphView.
+
+#include "graph_store.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+
+using std::string;
+using std::vector;
+
+namespace graph_utils {
+
+bool GraphView::IsConnected() const {
+  if (size_ == 0) {
+    return false;
+  }
+  WordSet component(words_per_row_);
+  GetConnectedComponent(rows_, words_per_row_, 0, component.data());
+  return SetSize(component.data(), words_per_row_) == size_;
+}
+
+void GraphView::GetAdjMatrix(vector<string> *v) const {
+  Graph(size_, rows_).GetAdjMatrix(v);
+}
+
+GraphStore::GraphStore(const int n)
+    : order_(n), words_per_graph_(n * WordsNeeded(n)), size_(0) {}
+
+void GraphStore::Reserve(const size_t count) {
+  rows_.reserve(count * words_per_graph_);
+}
+
+void GraphStore::AppendRows(const Word *rows) {
+  const size_t end = rows_.size();
+  std::less<const Word *> before;
+  if (end > 0 && !before(rows, rows_.data()) &&
+      before(rows, rows_.data() + end)) {
+    // The rows are a graph of this store, which growing the store may move,
+    // so they are copied by their offset.
+    const size_t offset = rows - rows_.data();
+    rows_.resize(end + words_per_graph_);
+    std::copy(rows_.begin() + offset,
+              rows_.begin() + offset + words_per_graph_, rows_.begin() + end);
+  } else {
+    rows_.insert(rows_.end(), rows, rows + words_per_graph_);
+  }
+  ++size_;
+}
+
+void GraphStore::PopBack() {
+  rows_.resize(rows_.size() - words_per_graph_);
+  --size_;
+}
+
+void GraphStore::Clear() {
+  rows_.clear();
+  size_ = 0;
+}
+
+} // namespace graph_utils
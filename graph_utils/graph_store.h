@@ -0,0 +1,182 @@
+// A compact container for many graphs of the same order. The adjacency rows of
+// the graphs are packed back to back in a single buffer, n * WordsNeeded(n)
+// words per graph, with no per-graph object, allocation or degree bookkeeping.
+// This is the form in which the generators hand over whole levels of graphs.
+//
+// The graphs are accessed through GraphView, a read-only view of the rows of
+// a graph inside the store. GraphView has the word-level interface of Graph, so
+// the template checks of the filters run on it directly; a Graph can be made
+// from it with Graph(view.size(), view.GetRow(0)).
+
+#ifndef GRAPH_UTILS_GRAPH_STORE_H_
+#define GRAPH_UTILS_GRAPH_STORE_H_
+
+#include <stddef.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "bit_utils.h"
+#include "graph.h"
+
+namespace graph_utils {
+
+class GraphView {
+public:
+  // Views the graph of order 'n' with the given adjacency rows, stored back to
+  // back with WordsNeeded(n) words per row. The rows are not copied and must
+  // outlive the view.
+  GraphView(const int n, const Word *rows)
+      : size_(n), words_per_row_(WordsNeeded(n)), rows_(rows) {}
+  // Views the rows of 'g'.
+  explicit GraphView(const Graph &g)
+      : size_(g.size()), words_per_row_(g.words_per_row()),
+        rows_(g.GetRow(0)) {}
+
+  int size() const { return size_; }
+  int words_per_row() const { return words_per_row_; }
+  const Word *GetRow(const int v) const { return &rows_[v * words_per_row_]; }
+
+  bool HasEdge(const int v1, const int v2) const {
+    return IsElement(GetRow(v1), v2);
+  }
+
+  int CountCommonNeighbours(const int v1, const int v2) const {
+    return IntersectionSize(GetRow(v1), GetRow(v2), words_per_row_);
+  }
+
+  // Unlike in Graph, the degrees are counted on every call.
+  int Degree(const int v) const {
+    return SetSize(GetRow(v), words_per_row_);
+  }
+  int GetNumberOfEdges() const {
+    return SetSize(rows_, size_ * words_per_row_) / 2;
+  }
+
+  bool IsConnected() const;
+  void GetAdjMatrix(std::vector<std::string> *v) const;
+
+private:
+  int size_;
+  int words_per_row_;
+  const Word *rows_;
+};
+
+class GraphStore {
+public:
+  class const_iterator;
+
+  // Creates an empty store for graphs of order 'n'.
+  explicit GraphStore(const int n);
+
+  int order() const { return order_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // The number of words taken by the rows of a single graph.
+  size_t words_per_graph() const { return words_per_graph_; }
+
+  // Reserves memory for 'count' graphs.
+  void Reserve(const size_t count);
+
+  // Appends a graph given by its adjacency rows, stored back to back with
+  // WordsNeeded(order()) words per row. The rows may be those of a graph of
+  // this store, e.g. store.Append(store[i]).
+  void AppendRows(const Word *rows);
+
+  // Appends a copy of 'g', which must be of order order(). 'GraphType' may be
+  // any graph type with contiguous rows of WordsNeeded(order()) words, e.g.
+  // Graph, FixedGraph and GraphView.
+  template <typename GraphType> void Append(const GraphType &g) {
+    AppendRows(g.GetRow(0));
+  }
+
+  // Removes the last graph.
+  void PopBack();
+
+  // Removes all graphs. The memory is kept for reuse.
+  void Clear();
+
+  // Random access to the graphs in the order they were appended.
+  const Word *GetRows(const size_t i) const {
+    return &rows_[i * words_per_graph_];
+  }
+  GraphView operator[](const size_t i) const {
+    return GraphView(order_, GetRows(i));
+  }
+  GraphView back() const { return (*this)[size_ - 1]; }
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+private:
+  int order_;
+  size_t words_per_graph_;
+  size_t size_;
+  std::vector<Word> rows_;
+};
+
+// Iterates over the graphs of a store, viewing each of them in turn.
+class GraphStore::const_iterator
+    : public std::iterator<std::random_access_iterator_tag, GraphView,
+                           ptrdiff_t, const GraphView *, GraphView> {
+public:
+  const_iterator(const GraphStore *store, const size_t index)
+      : store_(store), index_(index) {}
+
+  GraphView operator*() const { return (*store_)[index_]; }
+  GraphView operator[](const ptrdiff_t d) const {
+    return (*store_)[index_ + d];
+  }
+
+  const_iterator &operator++() {
+    ++index_;
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator old = *this;
+    ++index_;
+    return old;
+  }
+  const_iterator &operator--() {
+    --index_;
+    return *this;
+  }
+  const_iterator &operator+=(const ptrdiff_t d) {
+    index_ += d;
+    return *this;
+  }
+  const_iterator operator+(const ptrdiff_t d) const {
+    return const_iterator(store_, index_ + d);
+  }
+  ptrdiff_t operator-(const const_iterator &other) const {
+    return (ptrdiff_t) index_ - (ptrdiff_t) other.index_;
+  }
+
+  bool operator==(const const_iterator &other) const {
+    return index_ == other.index_ && store_ == other.store_;
+  }
+  bool operator!=(const const_iterator &other) const {
+    return !(*this == other);
+  }
+  bool operator<(const const_iterator &other) const {
+    return index_ < other.index_;
+  }
+
+private:
+  const GraphStore *store_;
+  size_t index_;
+};
+
+inline GraphStore::const_iterator GraphStore::begin() const {
+  return const_iterator(this, 0);
+}
+
+inline GraphStore::const_iterator GraphStore::end() const {
+  return const_iterator(this, size_);
+}
+
+} // namespace graph_utils
+
+#endif // GRAPH_UTILS_GRAPH_STORE_H_
@@ -0,0 +1,151 @@
+// Unit tests for GraphStore and GraphView.
+
+#include "graph_store.h"
+
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "graph_utilities.h"
+#include "gtest/gtest.h"
+#include "nauty_utils/nauty_wrapper.h"
+
+using nauty_utils::IsomorphismChecker;
+using std::string;
+using std::vector;
+
+namespace graph_utils {
+namespace {
+
+void ExpectVectorsEq(const vector<string> &v1, const vector<string> &v2) {
+  ASSERT_EQ(v1.size(), v2.size());
+  for (size_t i = 0; i < v1.size(); ++i) {
+    EXPECT_EQ(v1[i], v2[i]);
+  }
+}
+
+} // namespace
+
+TEST(GraphStoreTest, AppendAndAccess) {
+  vector<string> path({"0100", "1010", "0101", "0010"});
+  vector<string> star({"0111", "1000", "1000", "1000"});
+  GraphStore store(4);
+  EXPECT_TRUE(store.empty());
+  EXPECT_EQ(4, store.order());
+  store.Append(Graph(path));
+  Graph g(star);
+  store.AppendRows(g.GetRow(0));
+  ASSERT_EQ(2, store.size());
+  // The graphs are stored back to back.
+  EXPECT_EQ(store.GetRows(0) + store.words_per_graph(), store.GetRows(1));
+
+  vector<string> result;
+  store[0].GetAdjMatrix(&result);
+  ExpectVectorsEq(path, result);
+  store.back().GetAdjMatrix(&result);
+  ExpectVectorsEq(star, result);
+
+  const GraphView view = store[1];
+  EXPECT_EQ(4, view.size());
+  EXPECT_EQ(3, view.Degree(0));
+  EXPECT_EQ(1, view.Degree(3));
+  EXPECT_EQ(3, view.GetNumberOfEdges());
+  EXPECT_TRUE(view.HasEdge(2, 0));
+  EXPECT_FALSE(view.HasEdge(2, 3));
+  EXPECT_EQ(1, view.CountCommonNeighbours(1, 2));
+  EXPECT_TRUE(view.IsConnected());
+
+  // The store keeps a copy of the rows.
+  g.AddEdge(1, 2);
+  EXPECT_FALSE(store[1].HasEdge(1, 2));
+}
+
+TEST(GraphStoreTest, Iteration) {
+  GraphStore store(70);
+  for (int i = 0; i < 5; ++i) {
+    Graph g(70);
+    g.AddEdge(i, 69);
+    store.Append(g);
+  }
+  ASSERT_EQ(5, store.end() - store.begin());
+  int i = 0;
+  for (GraphStore::const_iterator it = store.begin(); it != store.end();
+       ++it, ++i) {
+    EXPECT_EQ(1, (*it).GetNumberOfEdges());
+    EXPECT_TRUE((*it).HasEdge(69, i));
+    EXPECT_FALSE((*it).IsConnected());
+  }
+  EXPECT_TRUE(store.begin()[3].HasEdge(3, 69));
+}
+
+TEST(GraphStoreTest, PopBackAndClear) {
+  GraphStore store(3);
+  Graph triangle(3);
+  triangle.AddEdge(0, 1);
+  triangle.AddEdge(1, 2);
+  triangle.AddEdge(0, 2);
+  store.Append(Graph(3));
+  store.Append(triangle);
+  store.PopBack();
+  ASSERT_EQ(1, store.size());
+  EXPECT_EQ(0, store.back().GetNumberOfEdges());
+  store.Append(triangle);
+  EXPECT_EQ(3, store.back().GetNumberOfEdges());
+  store.Clear();
+  EXPECT_TRUE(store.empty());
+  EXPECT_TRUE(store.begin() == store.end());
+}
+
+TEST(GraphStoreTest, AppendFromSameStore) {
+  // Three words per graph, so every append may move the rows.
+  GraphStore store(3);
+  Graph path(3);
+  path.AddEdge(0, 1);
+  path.AddEdge(1, 2);
+  store.Append(path);
+  store.Append(Graph(3));
+  for (int i = 0; i < 100; ++i) {
+    store.Append(store[i % 2 == 0 ? 0 : store.size() - 1]);
+  }
+  ASSERT_EQ(102, store.size());
+  for (size_t i = 2; i < store.size(); ++i) {
+    EXPECT_EQ(2, store[i].GetNumberOfEdges());
+    EXPECT_TRUE(store[i].HasEdge(0, 1));
+  }
+}
+
+TEST(GraphStoreTest, FiltersOnViews) {
+  vector<string> diamond({"0111", "1010", "1101", "1010"});
+  vector<string> cycle({"0101", "1010", "0101", "1010"});
+  GraphStore store(4);
+  store.Append(Graph(diamond));
+  store.Append(Graph(cycle));
+  EXPECT_FALSE(DiamondFreeGraph::IsDiamondFree(store[0]));
+  EXPECT_TRUE(DiamondFreeGraph::IsDiamondFree(store[1]));
+}
+
+TEST(GraphStoreTest, IsomorphismCheckerOutput) {
+  vector<string> path1({"0110", "1000", "1001", "0010"});
+  vector<string> path2({"0100", "1010", "0101", "0010"});
+  vector<string> star({"0111", "1000", "1000", "1000"});
+  // Without the optimization the graphs are kept in the order they are added.
+  IsomorphismChecker checker(false);
+  EXPECT_TRUE(checker.AddGraphToCheck(Graph(path1)));
+  EXPECT_FALSE(checker.AddGraphToCheck(Graph(path2)));
+  GraphStore input(4);
+  input.Append(Graph(star));
+  EXPECT_TRUE(checker.AddGraphToCheck(input[0]));
+
+  GraphStore store(4);
+  checker.GetAllNonIsomorphicGraphs(&store);
+  ASSERT_EQ(2, store.size());
+  vector<string> result;
+  store[0].GetAdjMatrix(&result);
+  ExpectVectorsEq(path1, result);
+  store[1].GetAdjMatrix(&result);
+  ExpectVectorsEq(star, result);
+  const Graph g(path2);
+  EXPECT_TRUE(IsomorphismChecker::AreIsomorphic(store[0], GraphView(g)));
+}
+
+} // namespace graph_utils
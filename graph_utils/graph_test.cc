@@ -1,6 +1,7 @@
 
 #include "gtest/gtest.h"
 #include "graph.h"
+#include "graph_fingerprint.h"
 
 namespace graph_utils {
 namespace {
@@ -108,6 +109,98 @@ TEST(GraphTest, Connected) {
   }
 }
 
+TEST(GraphTest, ConnectedComponents) {
+  {
+    vector<string> v({"0100", "1000", "0001", "0010"});
+    Graph g(v);
+    vector<int> labels;
+    EXPECT_EQ(2, g.GetConnectedComponents(&labels));
+    EXPECT_EQ(vector<int>({0, 0, 1, 1}), labels);
+  }
+  {
+    vector<string> v({"00100", "00000", "10001", "00000", "00100"});
+    Graph g(v);
+    vector<int> labels;
+    EXPECT_EQ(3, g.GetConnectedComponents(&labels));
+    EXPECT_EQ(vector<int>({0, 1, 0, 2, 0}), labels);
+  }
+  {
+    // A path spanning more than one word per row.
+    Graph g(130);
+    for (int i = 0; i + 1 < 130; ++i) {
+      g.AddEdge(i, i + 1);
+    }
+    EXPECT_TRUE(g.IsConnected());
+    g.RemoveEdge(64, 65);
+    EXPECT_FALSE(g.IsConnected());
+    vector<int> labels;
+    EXPECT_EQ(2, g.GetConnectedComponents(&labels));
+    EXPECT_EQ(0, labels[64]);
+    EXPECT_EQ(1, labels[65]);
+    EXPECT_EQ(1, labels[129]);
+  }
+}
+
+TEST(GraphTest, CutVerticesTest) {
+  {
+    // A path: all inner vertices are cut vertices.
+    vector<string> v({"0100", "1010", "0101", "0010"});
+    Graph g(v);
+    vector<bool> is_cut_vertex;
+    g.GetCutVertices(&is_cut_vertex);
+    EXPECT_EQ(vector<bool>({false, true, true, false}), is_cut_vertex);
+  }
+  {
+    // Two triangles sharing vertex 2, and an isolated vertex.
+    vector<string> v({"011000", "101000", "110110", "001010", "001100",
+                      "000000"});
+    Graph g(v);
+    vector<bool> is_cut_vertex;
+    g.GetCutVertices(&is_cut_vertex);
+    EXPECT_EQ(vector<bool>({false, false, true, false, false, false}),
+              is_cut_vertex);
+  }
+}
+
+TEST(GraphTest, WordLevelRows) {
+  // Vertices 0 and 1 are joined to every third vertex from 2 on, and 0 also
+  // to 100, so the rows span three words.
+  const int n = 130;
+  Graph g(n);
+  for (int v = 2; v < n; v += 3) {
+    g.AddEdge(0, v);
+    g.AddEdge(1, v);
+  }
+  g.AddEdge(0, 100);
+  ASSERT_EQ(3, g.words_per_row());
+  for (int v = 0; v < n; ++v) {
+    EXPECT_EQ(g.HasEdge(0, v), IsElement(g.GetRow(0), v));
+  }
+  EXPECT_EQ(g.Degree(0), SetSize(g.GetRow(0), g.words_per_row()));
+  EXPECT_EQ(43, g.CountCommonNeighbours(0, 1));
+  EXPECT_EQ(2, g.CountCommonNeighbours(2, 5));
+  EXPECT_EQ(1, g.CountCommonNeighbours(2, 100));
+
+  WordSet common(g.words_per_row());
+  g.GetCommonNeighbours(0, 1, common.data());
+  EXPECT_EQ(43, SetSize(common.data(), g.words_per_row()));
+  EXPECT_TRUE(IsElement(common.data(), 128));
+  EXPECT_FALSE(IsElement(common.data(), 100));
+  g.GetCommonNeighbours(2, 100, common.data());
+  EXPECT_EQ(0, NextElement(common.data(), g.words_per_row(), -1));
+  EXPECT_EQ(-1, NextElement(common.data(), g.words_per_row(), 0));
+
+  WordSet neighbours(g.words_per_row());
+  g.GetNeighbourhoodUnion(vector<int>({2, 100, 128}), neighbours.data());
+  EXPECT_EQ(2, SetSize(neighbours.data(), g.words_per_row()));
+  EXPECT_TRUE(IsElement(neighbours.data(), 0));
+  EXPECT_TRUE(IsElement(neighbours.data(), 1));
+  g.GetNeighbourhoodUnion(vector<int>({0, 1}), neighbours.data());
+  EXPECT_EQ(44, SetSize(neighbours.data(), g.words_per_row()));
+  g.GetNeighbourhoodUnion(vector<int>(), neighbours.data());
+  EXPECT_EQ(0, SetSize(neighbours.data(), g.words_per_row()));
+}
+
 TEST(GraphTest, GetNumberOfEdgesTest) {
   {
     vector<string> v({"010", "101", "010"});
@@ -135,23 +228,80 @@ TEST(GraphTest, GetDegSeqStringTest) {
   {
     vector<string> v({"010", "101", "010"});
     Graph g(v);
-    EXPECT_EQ("112", g.GetDegSeqString());
+    EXPECT_EQ("1,1,2", g.GetDegSeqString());
   }
   {
     vector<string> v({"0111", "1011", "1101", "1110"});
     Graph g(v);
-    EXPECT_EQ("3333", g.GetDegSeqString());
+    EXPECT_EQ("3,3,3,3", g.GetDegSeqString());
   }
   {
     vector<string> v({"0101", "1010", "0100", "1000"});
     Graph g(v);
-    EXPECT_EQ("1122", g.GetDegSeqString());
+    EXPECT_EQ("1,1,2,2", g.GetDegSeqString());
   }
   {
     vector<string> v({"0110", "1001", "1000", "0100"});
     Graph g(v);
-    EXPECT_EQ("1122", g.GetDegSeqString());
+    EXPECT_EQ("1,1,2,2", g.GetDegSeqString());
   }
+  {
+    // A star with ten leaves: the degree 10 is sorted as a number.
+    Graph g(11);
+    for (int v = 1; v < 11; ++v) {
+      g.AddEdge(0, v);
+    }
+    EXPECT_EQ("1,1,1,1,1,1,1,1,1,1,10", g.GetDegSeqString());
+  }
+}
+
+TEST(GraphTest, DegreesFollowEdgeChanges) {
+  vector<string> v({"0110", "1001", "1000", "0100"});
+  Graph g(v);
+  EXPECT_EQ(2, g.Degree(0));
+  EXPECT_EQ(1, g.Degree(3));
+  EXPECT_EQ(vector<int>({1, 1, 2, 2}), g.GetSortedDegrees());
+
+  g.AddEdge(2, 3);
+  g.AddEdge(3, 2); // Adding an existing edge changes nothing.
+  EXPECT_EQ(4, g.GetNumberOfEdges());
+  EXPECT_EQ(2, g.Degree(3));
+  EXPECT_EQ(vector<int>({2, 2, 2, 2}), g.GetSortedDegrees());
+
+  g.RemoveEdge(0, 1);
+  g.RemoveEdge(0, 3); // Removing a missing edge changes nothing.
+  EXPECT_EQ(3, g.GetNumberOfEdges());
+  EXPECT_EQ(1, g.Degree(0));
+  EXPECT_EQ(1, g.Degree(1));
+  EXPECT_EQ(vector<int>({1, 1, 2, 2}), g.GetSortedDegrees());
+  EXPECT_EQ("1,1,2,2", g.GetDegSeqString());
+
+  Graph copy(g);
+  copy.AddEdge(0, 1);
+  EXPECT_EQ(4, copy.GetNumberOfEdges());
+  EXPECT_EQ(3, g.GetNumberOfEdges());
+}
+
+TEST(GraphTest, FingerprintFollowsEdgeChanges) {
+  vector<string> v({"0110", "1001", "1000", "0100"});
+  Graph g(v);
+  const uint64_t fingerprint = g.GetFingerprint();
+  EXPECT_EQ(GetGraphFingerprint(g), fingerprint);
+  EXPECT_EQ(fingerprint, g.GetFingerprint());
+  EXPECT_TRUE(g.GetCachedCanonicalForm(1) == NULL);
+
+  g.AddEdge(2, 3);
+  EXPECT_EQ(GetGraphFingerprint(g), g.GetFingerprint());
+  EXPECT_NE(fingerprint, g.GetFingerprint());
+  g.RemoveEdge(2, 3);
+  EXPECT_EQ(fingerprint, g.GetFingerprint());
+
+  // The copies start from the cache of the original.
+  Graph copy(g);
+  EXPECT_EQ(fingerprint, copy.GetFingerprint());
+  copy.AddEdge(0, 3);
+  EXPECT_EQ(GetGraphFingerprint(copy), copy.GetFingerprint());
+  EXPECT_EQ(fingerprint, g.GetFingerprint());
 }
 
 } // namespace grap_utils
@@ -3,7 +3,11 @@
 #ifndef GRAPH_UTILS_GRAPH_UTILITIES_H_
 #define GRAPH_UTILS_GRAPH_UTILITIES_H_
 
+#include <vector>
+
+#include "bit_utils.h"
 #include "graph.h"
+#include "graph_arena.h"
 
 namespace graph_utils {
 
@@ -37,13 +41,23 @@ public:
   virtual bool IsSubsetSafe(const Graph &g,
                             const std::vector<int> &subset) const = 0;
 
-  // Creates all subsets of vertices for a graph of size 'n', which are later
-  // used to create all upper graphs for a given graph. Basic implementation is
-  // provided, no need to override. However, speed-ups are expected if subset
-  // elimination is done in  a clever way here.
-  virtual void
-  GetAllSubsetOfVertices(const int n,
-                         std::vector<std::vector<int> *> *all_subsets) const;
+  // Same as above for a subset given as a mask, which is how the canonical
+  // graph generator enumerates them. The basic implementation lists the
+  // vertices and calls the method above; filters that can check the mask
+  // directly should override it.
+  virtual bool IsSubsetSafe(const Graph &g, const SubsetMask subset) const;
+
+  // Returns true if every subset of a safe subset is safe too, as it is for
+  // hereditary properties. The generator then grows the subsets a vertex at
+  // a time and drops every superset of an unsafe one unseen. The basic
+  // implementation returns false.
+  virtual bool HasHereditarySubsets() const { return false; }
+  // Returns true if the safe 'subset' stays safe with vertex 'v', which is
+  // not in it, added. Only called if HasHereditarySubsets(). The basic
+  // implementation checks the extended subset as a whole; filters should
+  // check only what 'v' adds.
+  virtual bool IsSubsetExtensionSafe(const Graph &g, const SubsetMask subset,
+                                     const int v) const;
 
   // This method creates a graph, which is the lower object of the given graph
   // 'g' by removing vertex 'v' from it, and all edges incident on 'v'.
@@ -52,32 +66,229 @@ public:
   // implementation is provided, no need to override.
   virtual void ReduceGraphByRemovingVertex(const Graph &g, const int v,
                                            Graph **result) const;
+
+  // Same as above, but the new graph is created in (and owned by) 'arena'.
+  void ReduceGraphByRemovingVertex(const Graph &g, const int v,
+                                   GraphArena *arena, Graph **result) const;
 };
 
 // Diamond free graph filter, which extends CanonicalGrapgFilter and implements
 // GraphFilter could be used with both the brute-force graph generator and the
 // canonical graph generator.
-class DiamondFreeGraph : public CanonicalGraphFilter, public GraphFilter {
+//
+// Every check is a template for any graph type with the word-level interface of
+// Graph (e.g. FixedGraph). The class is final and the virtual methods are thin
+// inline adapters, so generators templated on DiamondFreeGraph bind the checks
+// statically and can inline them into the search.
+class DiamondFreeGraph final : public CanonicalGraphFilter, public GraphFilter {
 public:
   DiamondFreeGraph(){};
   virtual ~DiamondFreeGraph() {}
 
   // Override abstract method from CanonicalGraphFilter.
   virtual bool IsSubsetSafe(const Graph &g,
-                            const std::vector<int> &subset) const;
+                            const std::vector<int> &subset) const {
+    return IsSubsetSafe<Graph>(g, subset);
+  }
+  virtual bool IsSubsetSafe(const Graph &g, const SubsetMask subset) const {
+    return IsSubsetSafe<Graph>(g, subset);
+  }
+  virtual bool HasHereditarySubsets() const { return true; }
+  virtual bool IsSubsetExtensionSafe(const Graph &g, const SubsetMask subset,
+                                     const int v) const {
+    return IsSubsetExtensionSafe<Graph>(g, subset, v);
+  }
 
   // Implement the two methods from GraphFilter interface.
-  virtual bool IsNewGraphAcceptable(const int cur_vertex, const Graph &g) const;
+  virtual bool IsNewGraphAcceptable(const int cur_vertex,
+                                    const Graph &g) const {
+    return IsNewGraphAcceptable<Graph>(cur_vertex, g);
+  }
 
   virtual bool IsNewGraphAcceptable(const int cur_vertex,
                                     const std::vector<int> &new_adj_vertices,
-                                    const Graph &g) const;
+                                    const Graph &g) const {
+    return IsNewGraphAcceptable<Graph>(cur_vertex, new_adj_vertices, g);
+  }
+
+  template <typename GraphType>
+  bool IsSubsetSafe(const GraphType &g, const std::vector<int> &subset) const;
+  template <typename GraphType>
+  bool IsSubsetSafe(const GraphType &g, const SubsetMask subset) const;
+  template <typename GraphType>
+  bool IsSubsetExtensionSafe(const GraphType &g, const SubsetMask subset,
+                             const int v) const;
+
+  template <typename GraphType>
+  bool IsNewGraphAcceptable(const int cur_vertex, const GraphType &g) const;
+
+  template <typename GraphType>
+  bool IsNewGraphAcceptable(const int cur_vertex,
+                            const std::vector<int> &new_adj_vertices,
+                            const GraphType &g) const;
 
   // Returns true if a the graph 'g' is diamond free (i.e. between any four
   // vertices there are at most four edges).
-  static bool IsDiamondFree(const Graph &g);
+  static bool IsDiamondFree(const Graph &g) { return IsDiamondFree<Graph>(g); }
+
+  template <typename GraphType> static bool IsDiamondFree(const GraphType &g);
+
+private:
+  // Same as IsSubsetSafe() for the subset given as a set of
+  // g.words_per_row() words.
+  template <typename GraphType>
+  bool IsSubsetSetSafe(const GraphType &g, const Word *subset_set) const;
 };
 
+template <typename GraphType>
+bool DiamondFreeGraph::IsSubsetSafe(const GraphType &g,
+                                    const std::vector<int> &subset) const {
+  WordSet subset_set(g.words_per_row());
+  for (size_t i = 0; i < subset.size(); ++i) {
+    AddElement(subset_set.data(), subset[i]);
+  }
+  return IsSubsetSetSafe(g, subset_set.data());
+}
+
+template <typename GraphType>
+bool DiamondFreeGraph::IsSubsetSafe(const GraphType &g,
+                                    const SubsetMask subset) const {
+  WordSet subset_set(g.words_per_row());
+  SubsetMaskToSet(subset, subset_set.data(), g.words_per_row());
+  return IsSubsetSetSafe(g, subset_set.data());
+}
+
+// A subset is safe if every vertex of it has at most one neighbour in it, and
+// the ends of every edge inside it have no common neighbour. Adding 'v' only
+// adds the edges from 'v' to the subset.
+template <typename GraphType>
+bool DiamondFreeGraph::IsSubsetExtensionSafe(const GraphType &g,
+                                             const SubsetMask subset,
+                                             const int v) const {
+  int neighbour = -1;
+  for (SubsetMask rest = subset; rest != 0;) {
+    const int u = TakeSubsetVertex(&rest);
+    if (!g.HasEdge(u, v)) {
+      continue;
+    }
+    if (neighbour >= 0) {
+      return false; // Three collinear vertices in the subset.
+    }
+    neighbour = u;
+  }
+  if (neighbour < 0) {
+    return true;
+  }
+  for (SubsetMask rest = subset; rest != 0;) {
+    const int u = TakeSubsetVertex(&rest);
+    if (u != neighbour && g.HasEdge(u, neighbour)) {
+      return false; // Three collinear vertices, with 'neighbour' in between.
+    }
+  }
+  // Otherwise there is a triangle with two vertices in the subset.
+  return g.CountCommonNeighbours(neighbour, v) == 0;
+}
+
+template <typename GraphType>
+bool DiamondFreeGraph::IsSubsetSetSafe(const GraphType &g,
+                                       const Word *subset_set) const {
+  const int m = g.words_per_row();
+  for (int u = NextElement(subset_set, m, -1); u >= 0;
+       u = NextElement(subset_set, m, u)) {
+    if (IntersectionSize(g.GetRow(u), subset_set, m) > 1) {
+      return false; // Three collinear vertices in the subset.
+    }
+  }
+  for (int u = NextElement(subset_set, m, -1); u >= 0;
+       u = NextElement(subset_set, m, u)) {
+    const Word *row = g.GetRow(u);
+    for (int w = 0; w < m; ++w) {
+      Word adjacent_in_subset = row[w] & subset_set[w];
+      while (adjacent_in_subset) {
+        const int v = w * kWordSize + TakeFirstBit(&adjacent_in_subset);
+        if (g.CountCommonNeighbours(u, v) > 0) {
+          return false; // There is a triangle with two vertices in the subset.
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// A diamond is made of an edge (the diagonal) together with two common
+// neighbours of its end points. Hence every check below looks for an edge,
+// whose end points have at least two common neighbours.
+template <typename GraphType>
+bool DiamondFreeGraph::IsNewGraphAcceptable(const int cur_vertex,
+                                            const GraphType &g) const {
+  const int m = g.words_per_row();
+  const Word *cur_row = g.GetRow(cur_vertex);
+  for (int a = NextElement(cur_row, m, -1); a >= 0;
+       a = NextElement(cur_row, m, a)) {
+    if (g.CountCommonNeighbours(cur_vertex, a) > 1) {
+      return false; // 'cur_vertex' is on the diagonal of a diamond.
+    }
+    const Word *a_row = g.GetRow(a);
+    for (int w = 0; w < m; ++w) {
+      Word common = cur_row[w] & a_row[w];
+      while (common) {
+        const int b = w * kWordSize + TakeFirstBit(&common);
+        if (g.CountCommonNeighbours(a, b) > 1) {
+          return false; // 'cur_vertex' is a tip of a diamond with diagonal ab.
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template <typename GraphType>
+bool DiamondFreeGraph::IsNewGraphAcceptable(
+    const int cur_vertex, const std::vector<int> &new_adj_vertices,
+    const GraphType &g) const {
+  const int m = g.words_per_row();
+  const Word *cur_row = g.GetRow(cur_vertex);
+  // Looks for diamonds containing both 'cur_vertex' and 'a'.
+  for (size_t i = 0; i < new_adj_vertices.size(); ++i) {
+    const int a = new_adj_vertices[i];
+    const Word *a_row = g.GetRow(a);
+    const bool is_edge = g.HasEdge(cur_vertex, a);
+    if (is_edge && IntersectionSize(cur_row, a_row, m) > 1) {
+      return false; // The diagonal is the edge between 'cur_vertex' and 'a'.
+    }
+    for (int w = 0; w < m; ++w) {
+      Word common = cur_row[w] & a_row[w];
+      while (common) {
+        const int b = w * kWordSize + TakeFirstBit(&common);
+        const Word *b_row = g.GetRow(b);
+        if (is_edge && (IntersectionSize(cur_row, b_row, m) > 1 ||
+                        IntersectionSize(a_row, b_row, m) > 1)) {
+          return false; // The diagonal goes from 'b' to 'cur_vertex' or 'a'.
+        }
+        if (Intersects(cur_row, a_row, b_row, m)) {
+          return false; // 'cur_vertex' and 'a' are both tips of a diamond.
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template <typename GraphType>
+bool DiamondFreeGraph::IsDiamondFree(const GraphType &g) {
+  const int n = g.size();
+  const int m = g.words_per_row();
+  for (int a = 0; a < n; ++a) {
+    const Word *row = g.GetRow(a);
+    for (int b = NextElement(row, m, a); b >= 0; b = NextElement(row, m, b)) {
+      if (g.CountCommonNeighbours(a, b) > 1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 } // namespace graph_utils
 
 #endif // GRAPH_UTILS_GRAPH_UTILITIES_H_
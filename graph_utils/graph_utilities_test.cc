@@ -86,4 +86,72 @@ TEST(GraphUtilitiesTest, DiamondFreeGraphFilterTest) {
   }
 }
 
+namespace {
+
+// Accepts the subsets of at most two vertices, through the vector interface
+// only.
+class SmallSubsets : public CanonicalGraphFilter {
+public:
+  virtual bool IsSubsetSafe(const Graph &g, const vector<int> &subset) const {
+    return subset.size() <= 2;
+  }
+};
+
+// Returns the vertices of the subset 'mask'.
+vector<int> GetSubsetVertices(const SubsetMask mask) {
+  vector<int> vertices;
+  for (int v = 0; v < 64; ++v) {
+    if ((mask >> v) & 1) {
+      vertices.push_back(v);
+    }
+  }
+  return vertices;
+}
+
+} // namespace
+
+TEST(GraphUtilitiesTest, SubsetMaskFilterTest) {
+  // A triangle 0-1-2 and a path 2-3-4-5.
+  vector<string> v({"011000", "101000", "110100", "001010", "000101",
+                    "000010"});
+  Graph g(v);
+  DiamondFreeGraph filter;
+  SmallSubsets small;
+  const CanonicalGraphFilter &base = small;
+  for (SubsetMask mask = 1; mask < (SubsetMask(1) << g.size()); ++mask) {
+    const vector<int> subset = GetSubsetVertices(mask);
+    EXPECT_EQ(filter.IsSubsetSafe(g, subset), filter.IsSubsetSafe(g, mask));
+    // The basic implementation lists the vertices of the mask.
+    EXPECT_EQ(subset.size() <= 2, base.IsSubsetSafe(g, mask));
+  }
+  EXPECT_TRUE(filter.IsSubsetSafe(g, SubsetMask(0x09)));  // {0, 3}
+  EXPECT_FALSE(filter.IsSubsetSafe(g, SubsetMask(0x03))); // {0, 1}
+}
+
+TEST(GraphUtilitiesTest, SubsetExtensionTest) {
+  // A triangle 0-1-2 and a path 2-3-4-5.
+  vector<string> v({"011000", "101000", "110100", "001010", "000101",
+                    "000010"});
+  Graph g(v);
+  DiamondFreeGraph filter;
+  ASSERT_TRUE(filter.HasHereditarySubsets());
+  SmallSubsets small;
+  EXPECT_FALSE(small.HasHereditarySubsets());
+  for (SubsetMask mask = 0; mask < (SubsetMask(1) << g.size()); ++mask) {
+    if (mask != 0 && !filter.IsSubsetSafe(g, mask)) {
+      continue;
+    }
+    for (int u = 0; u < g.size(); ++u) {
+      if ((mask >> u) & 1) {
+        continue;
+      }
+      const SubsetMask extended = mask | (SubsetMask(1) << u);
+      EXPECT_EQ(filter.IsSubsetSafe(g, extended),
+                filter.IsSubsetExtensionSafe(g, mask, u));
+      EXPECT_EQ(PopCount(extended) <= 2,
+                small.IsSubsetExtensionSafe(g, mask, u));
+    }
+  }
+}
+
 } // namespace graph_utils
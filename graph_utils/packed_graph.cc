@@ -0,0 +1,156 @@
+// Implementation of PackedGraph.
+
+#include "packed_graph.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+using std::vector;
+
+namespace graph_utils {
+namespace {
+
+// Returns the 'count' (1 to kWordSize) bits of 'set' starting at bit 'start',
+// as the most significant bits of the result. The other bits are zero.
+Word GetBits(const Word *set, const int start, const int count) {
+  const int w = WordIndex(start);
+  const int offset = start % kWordSize;
+  Word bits = set[w] << offset;
+  if (offset != 0 && offset + count > kWordSize) {
+    bits |= set[w + 1] >> (kWordSize - offset);
+  }
+  return count == kWordSize ? bits : bits & ~(~Word(0) >> count);
+}
+
+// Sets the bits of 'set' starting at bit 'start' to the 'count' most
+// significant bits of 'bits'. The other bits of 'bits' must be zero and the
+// bits of 'set' must not be set yet.
+void PutBits(Word *set, const int start, const int count, const Word bits) {
+  const int w = WordIndex(start);
+  const int offset = start % kWordSize;
+  set[w] |= bits >> offset;
+  if (offset != 0 && offset + count > kWordSize) {
+    set[w + 1] |= bits << (kWordSize - offset);
+  }
+}
+
+// Returns the position of the edge {v1, v2}, v1 < v2, in a graph of order 'n'.
+int EdgeIndex(const int n, const int v1, const int v2) {
+  return v1 * n - v1 * (v1 + 1) / 2 + (v2 - v1 - 1);
+}
+
+} // namespace
+
+PackedGraph::PackedGraph(const int n, const Word *rows)
+    : size_(n), words_(PackedWords(n), 0) {
+  const int m = WordsNeeded(n);
+  int pos = 0;
+  // Row 'v' contributes its bits of the vertices after 'v', which are
+  // contiguous both in the row and in the packed form.
+  for (int v = 0; v < n; ++v) {
+    const Word *row = &rows[v * m];
+    for (int u = v + 1; u < n; u += kWordSize) {
+      const int count = std::min(kWordSize, n - u);
+      PutBits(words_.data(), pos, count, GetBits(row, u, count));
+      pos += count;
+    }
+  }
+}
+
+PackedGraph::PackedGraph(const Graph &g) : PackedGraph(g.size(), g.GetRow(0)) {}
+
+PackedGraph::PackedGraph(const GraphView &g)
+    : PackedGraph(g.size(), g.GetRow(0)) {}
+
+int PackedGraph::PackedWords(const int n) {
+  return n <= 1 ? 0 : WordsNeeded(n * (n - 1) / 2);
+}
+
+bool PackedGraph::HasEdge(const int v1, const int v2) const {
+  if (v1 == v2) {
+    return false;
+  }
+  return v1 < v2 ? IsElement(words_.data(), EdgeIndex(size_, v1, v2))
+                 : IsElement(words_.data(), EdgeIndex(size_, v2, v1));
+}
+
+int PackedGraph::GetNumberOfEdges() const {
+  return SetSize(words_.data(), words_.size());
+}
+
+void PackedGraph::Unpack(Word *rows) const {
+  const int n = size_;
+  const int m = WordsNeeded(n);
+  EmptySet(rows, n * m);
+  int pos = 0;
+  for (int v = 0; v < n; ++v) {
+    Word *row = &rows[v * m];
+    for (int u = v + 1; u < n; u += kWordSize) {
+      const int count = std::min(kWordSize, n - u);
+      Word bits = GetBits(words_.data(), pos, count);
+      pos += count;
+      PutBits(row, u, count, bits);
+      // The lower triangle is filled one edge at a time.
+      while (bits) {
+        AddElement(&rows[(u + TakeFirstBit(&bits)) * m], v);
+      }
+    }
+  }
+}
+
+void PackedGraph::Unpack(Graph *g) const {
+  WordSet rows(size_ * WordsNeeded(size_));
+  Unpack(rows.data());
+  *g = Graph(size_, rows.data());
+}
+
+void PackedGraph::Unpack(GraphStore *store) const {
+  WordSet rows(size_ * WordsNeeded(size_));
+  Unpack(rows.data());
+  store->AppendRows(rows.data());
+}
+
+bool PackedGraph::operator==(const PackedGraph &other) const {
+  return size_ == other.size_ && words_ == other.words_;
+}
+
+bool PackedGraph::operator<(const PackedGraph &other) const {
+  if (size_ != other.size_) {
+    return size_ < other.size_;
+  }
+  return words_ < other.words_;
+}
+
+size_t PackedGraph::Hash() const {
+  uint64_t hash = size_;
+  for (size_t i = 0; i < words_.size(); ++i) {
+    hash ^= words_[i] + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+void PackedGraph::Write(std::ostream *out) const {
+  const int32_t order = size_;
+  out->write(reinterpret_cast<const char *>(&order), sizeof(order));
+  out->write(reinterpret_cast<const char *>(words_.data()),
+             words_.size() * sizeof(Word));
+}
+
+bool PackedGraph::Read(std::istream *in) {
+  int32_t order;
+  if (!in->read(reinterpret_cast<char *>(&order), sizeof(order)) ||
+      order < 0) {
+    return false;
+  }
+  vector<Word> words(PackedWords(order));
+  if (!in->read(reinterpret_cast<char *>(words.data()),
+                words.size() * sizeof(Word))) {
+    return false;
+  }
+  size_ = order;
+  words_.swap(words);
+  return true;
+}
+
+} // namespace graph_utils
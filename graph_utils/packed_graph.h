@@ -0,0 +1,92 @@
+// A compact encoding of a simple graph, which keeps only the n(n-1)/2 bits of
+// the upper triangle of its adjacency matrix. The edge {i, j} with i < j is bit
+// i * n - i * (i + 1) / 2 + (j - i - 1) of the encoding, and the bits are laid
+// out in words as the sets of bit_utils.h. A packed graph takes a little less
+// than half the memory of the adjacency rows of Graph, so it is the form in
+// which large numbers of graphs are kept as keys of containers or written to
+// files.
+//
+// Packed graphs compare word at a time. Two packed graphs are equal iff the
+// graphs have the same order and the same (labelled) edges; the order they
+// define is otherwise arbitrary but total, so they can be kept in std::set and
+// std::map, and in the unordered containers through std::hash.
+
+#ifndef GRAPH_UTILS_PACKED_GRAPH_H_
+#define GRAPH_UTILS_PACKED_GRAPH_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "bit_utils.h"
+#include "graph.h"
+#include "graph_store.h"
+
+namespace graph_utils {
+
+class PackedGraph {
+public:
+  // Creates the graph of order 0.
+  PackedGraph() : size_(0) {}
+  // Packs the graph of order 'n' with the given adjacency rows, stored back to
+  // back with WordsNeeded(n) words per row. The rows of a nauty graph with
+  // m = WordsNeeded(n) can be packed as they are (see nauty_graph.h).
+  PackedGraph(const int n, const Word *rows);
+  explicit PackedGraph(const Graph &g);
+  explicit PackedGraph(const GraphView &g);
+
+  // Returns the number of words needed to pack a graph of order 'n'.
+  static int PackedWords(const int n);
+
+  int size() const { return size_; }
+  bool HasEdge(const int v1, const int v2) const;
+  int GetNumberOfEdges() const;
+
+  // Stores the adjacency rows of the graph into 'rows', which must hold
+  // size() * WordsNeeded(size()) words. These are also the rows of the graph
+  // as a nauty graph.
+  void Unpack(Word *rows) const;
+  // Replaces 'g' with the unpacked graph.
+  void Unpack(Graph *g) const;
+  // Appends the unpacked graph to 'store', which must be of order size().
+  void Unpack(GraphStore *store) const;
+
+  // The packed bits, PackedWords(size()) words. The bits past the last edge of
+  // the last word are zero.
+  const Word *data() const { return words_.data(); }
+  int num_words() const { return words_.size(); }
+
+  bool operator==(const PackedGraph &other) const;
+  bool operator!=(const PackedGraph &other) const { return !(*this == other); }
+  bool operator<(const PackedGraph &other) const;
+
+  size_t Hash() const;
+
+  // Writes the graph in a binary form: its order as a 32-bit integer followed
+  // by the packed words, in the byte order of the machine.
+  void Write(std::ostream *out) const;
+  // Reads a graph written by Write(). Returns false, leaving the graph
+  // unchanged, if there is no complete graph to read.
+  bool Read(std::istream *in);
+
+private:
+  int size_;
+  std::vector<Word> words_;
+};
+
+} // namespace graph_utils
+
+namespace std {
+
+template <> struct hash<graph_utils::PackedGraph> {
+  size_t operator()(const graph_utils::PackedGraph &g) const {
+    return g.Hash();
+  }
+};
+
+} // namespace std
+
+#endif // GRAPH_UTILS_PACKED_GRAPH_H_
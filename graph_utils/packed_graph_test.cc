@@ -0,0 +1,133 @@
+// Unit tests for PackedGraph.
+
+#include "packed_graph.h"
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "graph.h"
+#include "graph_store.h"
+#include "gtest/gtest.h"
+#include "test_graphs.h"
+#include "nauty_utils/nauty_wrapper.h"
+
+using nauty_utils::IsomorphismChecker;
+using std::string;
+using std::vector;
+
+namespace graph_utils {
+namespace {
+
+PackedGraph MakePackedGraph(const int n, const unsigned seed) {
+  Graph g(n);
+  AddRandomEdges(seed, 3, &g);
+  return PackedGraph(g);
+}
+
+void ExpectSameGraph(const Graph &expected, const Graph &actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (int i = 0; i < expected.size(); ++i) {
+    for (int j = 0; j < expected.size(); ++j) {
+      EXPECT_EQ(expected.HasEdge(i, j), actual.HasEdge(i, j));
+    }
+  }
+}
+
+} // namespace
+
+TEST(PackedGraphTest, Encoding) {
+  vector<string> v({"0110", "1001", "1000", "0100"});
+  PackedGraph packed((Graph(v)));
+  EXPECT_EQ(4, packed.size());
+  EXPECT_EQ(1, packed.num_words());
+  EXPECT_EQ(3, packed.GetNumberOfEdges());
+  // The upper triangle row by row: 01 02 03 12 13 23.
+  EXPECT_EQ(Word(0xC8) << 56, packed.data()[0]);
+  EXPECT_TRUE(packed.HasEdge(3, 1));
+  EXPECT_FALSE(packed.HasEdge(2, 3));
+  EXPECT_FALSE(packed.HasEdge(2, 2));
+
+  EXPECT_EQ(0, PackedGraph().num_words());
+  EXPECT_EQ(0, PackedGraph::PackedWords(1));
+  EXPECT_EQ(1, PackedGraph::PackedWords(11));
+  EXPECT_EQ(2, PackedGraph::PackedWords(12));
+  // 66 vertices take 2145 bits, where the rows take 66 * 2 words.
+  EXPECT_EQ(34, PackedGraph::PackedWords(66));
+}
+
+TEST(PackedGraphTest, RoundTrip) {
+  for (int n = 0; n <= 140; n += 7) {
+    Graph g(n);
+    AddRandomEdges(n, 3, &g);
+    const PackedGraph packed(g);
+    EXPECT_EQ(g.GetNumberOfEdges(), packed.GetNumberOfEdges());
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        ASSERT_EQ(g.HasEdge(i, j), packed.HasEdge(i, j));
+      }
+    }
+    Graph unpacked(1);
+    packed.Unpack(&unpacked);
+    ExpectSameGraph(g, unpacked);
+    EXPECT_EQ(g.GetSortedDegrees(), unpacked.GetSortedDegrees());
+
+    GraphStore store(n);
+    packed.Unpack(&store);
+    EXPECT_TRUE(PackedGraph(store[0]) == packed);
+  }
+}
+
+TEST(PackedGraphTest, Comparisons) {
+  const PackedGraph g1 = MakePackedGraph(30, 1);
+  const PackedGraph g2 = MakePackedGraph(30, 2);
+  const PackedGraph g3 = MakePackedGraph(31, 1);
+  EXPECT_TRUE(g1 == MakePackedGraph(30, 1));
+  EXPECT_TRUE(g1 != g2);
+  EXPECT_TRUE(g1 != g3);
+  EXPECT_NE(g1 < g2, g2 < g1);
+  EXPECT_FALSE(g1 < g1);
+  // Smaller orders come first.
+  EXPECT_TRUE(g1 < g3);
+
+  std::set<PackedGraph> ordered;
+  std::unordered_set<PackedGraph> unordered;
+  for (unsigned seed = 0; seed < 20; ++seed) {
+    ordered.insert(MakePackedGraph(20, seed % 10));
+    unordered.insert(MakePackedGraph(20, seed % 10));
+  }
+  EXPECT_EQ(10, ordered.size());
+  EXPECT_EQ(10, unordered.size());
+}
+
+TEST(PackedGraphTest, WriteAndRead) {
+  std::stringstream stream;
+  vector<PackedGraph> graphs;
+  for (int n = 0; n < 80; n += 9) {
+    graphs.push_back(MakePackedGraph(n, 3 * n));
+    graphs.back().Write(&stream);
+  }
+  PackedGraph packed;
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    ASSERT_TRUE(packed.Read(&stream));
+    EXPECT_TRUE(graphs[i] == packed);
+  }
+  EXPECT_FALSE(packed.Read(&stream));
+  EXPECT_TRUE(graphs.back() == packed);
+}
+
+TEST(PackedGraphTest, IsomorphismChecker) {
+  vector<string> path1({"0110", "1000", "1001", "0010"});
+  vector<string> path2({"0100", "1010", "0101", "0010"});
+  IsomorphismChecker checker(false);
+  EXPECT_TRUE(checker.AddGraphToCheck(PackedGraph(Graph(path1))));
+  EXPECT_FALSE(checker.AddGraphToCheck(PackedGraph(Graph(path2))));
+  vector<PackedGraph> result;
+  checker.GetAllNonIsomorphicGraphs(&result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_TRUE(PackedGraph(Graph(path1)) == result[0]);
+}
+
+} // namespace graph_utils
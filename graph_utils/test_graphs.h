@@ -0,0 +1,52 @@
+// Graphs shared by the unit tests: pseudo-random graphs, the same for the same
+// seed on every platform, and their relabellings.
+
+#ifndef GRAPH_UTILS_TEST_GRAPHS_H_
+#define GRAPH_UTILS_TEST_GRAPHS_H_
+
+#include <vector>
+
+#include "graph.h"
+
+namespace graph_utils {
+
+// Adds a pseudo-random set of edges to the graph 'g', each with probability
+// 1 / 'sparsity'. The edges depend on 'seed' and the order of 'g' only.
+inline void AddRandomEdges(const unsigned seed, const int sparsity, Graph *g) {
+  unsigned state = seed;
+  for (int i = 0; i < g->size(); ++i) {
+    for (int j = i + 1; j < g->size(); ++j) {
+      state = state * 1103515245 + 12345;
+      if ((state >> 16) % sparsity == 0) {
+        g->AddEdge(i, j);
+      }
+    }
+  }
+}
+
+// Adds to 'relabelled', a graph without edges of the order of 'g', the edges of
+// 'g' with vertex v renamed to labels[v].
+inline void Relabel(const Graph &g, const std::vector<int> &labels,
+                    Graph *relabelled) {
+  const int n = g.size();
+  for (int i = 0; i < n; ++i) {
+    for (int j = i + 1; j < n; ++j) {
+      if (g.HasEdge(i, j)) {
+        relabelled->AddEdge(labels[i], labels[j]);
+      }
+    }
+  }
+}
+
+// Same as above, with vertex v renamed to n - 1 - v.
+inline void Reverse(const Graph &g, Graph *reversed) {
+  std::vector<int> labels(g.size());
+  for (int v = 0; v < g.size(); ++v) {
+    labels[v] = g.size() - 1 - v;
+  }
+  Relabel(g, labels, reversed);
+}
+
+} // namespace graph_utils
+
+#endif // GRAPH_UTILS_TEST_GRAPHS_H_
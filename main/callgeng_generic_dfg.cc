@@ -14,10 +14,15 @@
 #include <vector>
 
 #include "nauty/gtools.h"
+#include "nauty_utils/nauty_graph.h"
 #include "graph_utils/graph.h"
+#include "graph_utils/graph_arena.h"
+#include "graph_utils/graph_store.h"
 #include "graph_utils/graph_utilities.h"
 
 using graph_utils::Graph;
+using graph_utils::GraphView;
+using nauty_utils::ViewNautyGraph;
 using std::pair;
 using std::string;
 
@@ -25,19 +30,14 @@ namespace {
 
 graph_utils::DiamondFreeGraph filter;
 
-// A helper function for converting from graph in NAUTY format to the graph
-// format used in this project.
-void ConvertNautyGraphToGraph(graph *g, int n, Graph *graph) {
-  set *gi = (set *)g;
-  const int m = (n + WORDSIZE - 1) / WORDSIZE;
-
-  for (int i = 0; i < n - 1; ++i, gi += m) {
-    for (int j = i + 1; j < n; ++j) {
-      if (ISELEMENT(gi, j)) {
-        graph->AddEdge(i, j);
-      }
-    }
+// Returns the number of edges of a graph in NAUTY format.
+int CountNautyEdges(graph *g, int n) {
+  const int m = SETWORDSNEEDED(n);
+  int degree_sum = 0;
+  for (int i = 0; i < n * m; ++i) {
+    degree_sum += POPCOUNT(g[i]);
   }
+  return degree_sum / 2;
 }
 
 void ExportGraphToFile(const string &filename, const Graph &g) {
@@ -62,36 +62,39 @@ static int all_graphs;
 static int counter;
 static int max_size;
 static std::vector<Graph *> extremal_graphs;
+// Owns the graphs in 'extremal_graphs'.
+static graph_utils::GraphArena extremal_arena;
 static string output_file_name;
 
 // Function which is called by GENG on final graph.
 void OUTPROC(FILE *outfile, graph *g, int n) {
   ++all_graphs;
-  Graph *graph = new Graph(n);
-  ConvertNautyGraphToGraph(g, n, graph);
+  const int edge_count = CountNautyEdges(g, n);
+  if (edge_count > max_size) {
+    max_size = edge_count;
+    counter = 0;
+    extremal_graphs.clear();
+    extremal_arena.Clear();
+  }
+  // The rows of 'g' are copied as they are (see nauty_utils/nauty_graph.h).
+  Graph *graph = extremal_arena.NewGraph(n, ViewNautyGraph(g, n).GetRow(0));
   if (!output_file_name.empty()) {
     ExportGraphToFile(output_file_name, *graph);
   }
-  int edge_count = graph->GetNumberOfEdges();
-  if (edge_count > max_size) {
-    max_size = edge_count;
-    counter = 1;
-    while (!extremal_graphs.empty()) {
-      delete extremal_graphs.back();
-      extremal_graphs.pop_back();
-    }
-    extremal_graphs.push_back(graph);
-  } else if (edge_count == max_size) {
+  if (edge_count == max_size) {
     ++counter;
     extremal_graphs.push_back(graph);
+  } else {
+    // Only extremal graphs are kept. The graph is the last one in the arena.
+    extremal_arena.Truncate(extremal_arena.size() - 1);
   }
 }
 
 // Returns non-zero value if the graph should be rejected. Returns 0 if the
 // graph has to be kept.
 int PRUNE(graph *g, int n, int maxn) {
-  Graph graph(n);
-  ConvertNautyGraphToGraph(g, n, &graph);
+  // The filter runs on the rows of 'g' without copying them.
+  const GraphView graph = ViewNautyGraph(g, n);
   if (filter.IsDiamondFree(graph)) {
     return 0;
   }
@@ -3,28 +3,34 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
 #include "graph_utils/graph_utilities.h"
 #include "graph_utils/canonical_graph_generator.h"
+#include "nauty_utils/canonizer.h"
 
 using std::string;
 using std::vector;
 using graph_utils::Graph;
-using graph_utils::CanonicalGraphGenerator;
+using graph_utils::GraphStore;
+using graph_utils::GraphView;
+using graph_utils::BasicCanonicalGraphGenerator;
 using graph_utils::DiamondFreeGraph;
 
 namespace {
-void ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
+void ExportGraphsToFile(const string &filename, const GraphStore &graphs) {
   std::ofstream f;
   f.open(filename, std::ios::app);
   for (size_t i = 0; i < graphs.size(); ++i) {
-    if (!graphs[i]->IsConnected()) {
+    const GraphView g = graphs[i];
+    if (!g.IsConnected()) {
       continue;
     }
     vector<string> matrix;
-    graphs[i]->GetAdjMatrix(&matrix);
+    g.GetAdjMatrix(&matrix);
     for (size_t j = 0; j < matrix.size(); ++j) {
       f << matrix[j] << std::endl;
     }
@@ -39,11 +45,14 @@ void ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
 int main() {
   const int kGraphOrder = 9;
   const string kFileName = "canonical_dfg_8.txt";
-  CanonicalGraphGenerator gen(kGraphOrder, new DiamondFreeGraph());
-  vector<Graph *> *graphs = new vector<Graph *>();
+  BasicCanonicalGraphGenerator<DiamondFreeGraph> gen(kGraphOrder,
+                                                     new DiamondFreeGraph());
+  GraphStore graphs(kGraphOrder);
   printf("Generating diamond-free graphs of order %d\n", kGraphOrder);
+  gen.set_num_threads(std::thread::hardware_concurrency());
   gen.GenerateGraphs(&graphs, true);
-  ExportGraphsToFile("canonical_dfg_8.txt", *graphs);
+  nauty_utils::PrintCanonizerStats(stdout);
+  ExportGraphsToFile("canonical_dfg_8.txt", graphs);
   printf("Adjacency matrices for the final graphs are exported into the "
          "file: %s\n",
          kFileName.c_str());
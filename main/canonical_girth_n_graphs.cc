@@ -4,23 +4,28 @@
 #include <iostream>
 #include <string>
 #include <string.h>
+#include <thread>
 #include <vector>
 
 #include "graph_utils/girth_5_graph.h"
 #include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
 #include "graph_utils/graph_utilities.h"
 #include "graph_utils/canonical_graph_generator.h"
+#include "nauty_utils/canonizer.h"
 
 using std::string;
 using std::vector;
 using graph_utils::Graph;
-using graph_utils::CanonicalGraphGenerator;
+using graph_utils::GraphStore;
+using graph_utils::GraphView;
+using graph_utils::BasicCanonicalGraphGenerator;
 using graph_utils::Girth5Graph;
 using graph_utils::GirthNGraph;
 
 namespace {
 
-int GetMaxGirth(const Graph &g) {
+int GetMaxGirth(const GraphView &g) {
   std::unique_ptr<GirthNGraph> filter;
   int max_girth = 0;
   for (int i = 3; i < g.size(); ++i) {
@@ -33,25 +38,26 @@ int GetMaxGirth(const Graph &g) {
   return max_girth;
 }
 
-int ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
+int ExportGraphsToFile(const string &filename, const GraphStore &graphs) {
   std::ofstream f;
   f.open(filename, std::ios::app);
   int max_edges = 0;
-  vector<Graph *> extremal;
+  vector<GraphView> extremal;
   for (size_t i = 0; i < graphs.size(); ++i) {
-    if (!graphs[i]->IsConnected()) {
+    const GraphView g = graphs[i];
+    if (!g.IsConnected()) {
       continue;
     }
-    int cur_edge_count = graphs[i]->GetNumberOfEdges();
+    int cur_edge_count = g.GetNumberOfEdges();
     if (max_edges < cur_edge_count) {
       max_edges = cur_edge_count;
       extremal.clear();
-      extremal.push_back(graphs[i]);
+      extremal.push_back(g);
     } else if (max_edges == cur_edge_count) {
-      extremal.push_back(graphs[i]);
+      extremal.push_back(g);
     }
     vector<string> matrix;
-    graphs[i]->GetAdjMatrix(&matrix);
+    g.GetAdjMatrix(&matrix);
     for (size_t j = 0; j < matrix.size(); ++j) {
       f << matrix[j] << std::endl;
     }
@@ -61,7 +67,7 @@ int ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
 
   int max_girth = 0;
   for (size_t i = 0; i < extremal.size(); ++i) {
-    max_girth = std::max(max_girth, GetMaxGirth(*extremal[i]));
+    max_girth = std::max(max_girth, GetMaxGirth(extremal[i]));
   }
   printf("(count,size,max_girth) =  (%lu,%d,%d)\n", extremal.size(), max_edges,
          max_girth);
@@ -75,13 +81,15 @@ int main() {
   printf("Generating graphs of minimum girth %d\n", kMinGraphGirth);
   for (int order = 3; order < kMaxOrder; ++order) {
     GirthNGraph filter(kMinGraphGirth);
-    CanonicalGraphGenerator gen(order, &filter);
-    vector<Graph *> *graphs = new vector<Graph *>();
+    BasicCanonicalGraphGenerator<GirthNGraph> gen(order, &filter);
+    GraphStore graphs(order);
+    gen.set_num_threads(std::thread::hardware_concurrency());
     gen.GenerateGraphs(&graphs, true);
+    nauty_utils::PrintCanonizerStats(stdout);
     const string filename = "results/canonical_girth_" +
                             std::to_string(kMinGraphGirth) + "_order_" +
                             std::to_string(order) + ".txt";
-    ExportGraphsToFile(filename, *graphs);
+    ExportGraphsToFile(filename, graphs);
     printf("Generated graphs of order %d. Exported to file %s\n", order,
            filename.c_str());
   }
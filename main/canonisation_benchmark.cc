@@ -0,0 +1,135 @@
+// A program to compare the canonisation options on the regular graphs of
+// nauty_utils/testdata, on which plain refinement splits few cells. Run it from
+// the root of the repository.
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "graph_utils/graph.h"
+#include "graph_utils/packed_graph.h"
+#include "nauty_utils/canonizer.h"
+#include "nauty_utils/nauty_workspace.h"
+
+using std::string;
+using std::vector;
+using graph_utils::Graph;
+using graph_utils::GraphView;
+using graph_utils::PackedGraph;
+using nauty_utils::CanonisationOptions;
+using nauty_utils::Canonizer;
+using nauty_utils::NautyWorkspace;
+
+namespace {
+
+const char *kFileNames[] = {"nauty_utils/testdata/F22_5_4.3.3.txt",
+                            "nauty_utils/testdata/mike24.txt",
+                            "nauty_utils/testdata/mike32.txt"};
+
+// Each graph is canonised this many times.
+const int kRepetitions = 20;
+
+struct Configuration {
+  const char *name;
+  nauty_utils::CanonizerType type;
+  CanonisationOptions options;
+};
+
+// Reads the adjacency matrices in 'filename' into 'graphs'.
+void ReadGraphsFromFile(const string &filename, vector<Graph> *graphs) {
+  std::ifstream infile(filename);
+  string s;
+  vector<string> mat;
+  while ((infile >> s)) {
+    mat.push_back(s);
+    if (s.size() == mat.size()) {
+      graphs->push_back(Graph(mat));
+      mat.clear();
+    }
+  }
+}
+
+vector<Configuration> GetConfigurations() {
+  vector<Configuration> configurations;
+  Configuration plain = {"dense", nauty_utils::kDenseNauty,
+                         CanonisationOptions()};
+  configurations.push_back(plain);
+
+  const struct {
+    const char *name;
+    nauty_utils::VertexInvariant invariant;
+    int max_level;
+    int arg;
+  } invariants[] = {{"dense adjtriang", nauty_utils::kAdjTriang, 1, 0},
+                    {"dense cellquads", nauty_utils::kCellQuads, 2, 0},
+                    {"dense distances", nauty_utils::kDistances, 1, 0},
+                    {"dense triples", nauty_utils::kTriples, 1, 0},
+                    {"dense twopaths", nauty_utils::kTwoPaths, 1, 0}};
+  for (size_t i = 0; i < sizeof(invariants) / sizeof(invariants[0]); ++i) {
+    Configuration c = {invariants[i].name, nauty_utils::kDenseNauty,
+                       CanonisationOptions()};
+    c.options.invariant = invariants[i].invariant;
+    c.options.max_invariant_level = invariants[i].max_level;
+    c.options.invariant_arg = invariants[i].arg;
+    configurations.push_back(c);
+  }
+
+  Configuration by_degree = {"dense degree", nauty_utils::kDenseNauty,
+                             CanonisationOptions()};
+  by_degree.options.colouring = nauty_utils::kColourByDegree;
+  configurations.push_back(by_degree);
+
+  Configuration sparse = {"sparse", nauty_utils::kSparseNauty,
+                          CanonisationOptions()};
+  configurations.push_back(sparse);
+  Configuration sparse_distances = {"sparse distances",
+                                    nauty_utils::kSparseNauty,
+                                    CanonisationOptions()};
+  sparse_distances.options.invariant = nauty_utils::kDistances;
+  configurations.push_back(sparse_distances);
+
+  Configuration traces = {"Traces", nauty_utils::kTraces,
+                          CanonisationOptions()};
+  configurations.push_back(traces);
+  return configurations;
+}
+
+} // namespace
+
+int main() {
+  const vector<Configuration> configurations = GetConfigurations();
+  for (size_t f = 0; f < sizeof(kFileNames) / sizeof(kFileNames[0]); ++f) {
+    vector<Graph> graphs;
+    ReadGraphsFromFile(kFileNames[f], &graphs);
+    if (graphs.empty()) {
+      fprintf(stderr, "No graphs in %s\n", kFileNames[f]);
+      return 1;
+    }
+    printf("%s: %zu graphs of order %d\n", kFileNames[f], graphs.size(),
+           graphs[0].size());
+    for (size_t c = 0; c < configurations.size(); ++c) {
+      Canonizer *canonizer = nauty_utils::GetCanonizer(configurations[c].type);
+      const CanonisationOptions saved = canonizer->options();
+      canonizer->set_options(configurations[c].options);
+      NautyWorkspace workspace(canonizer);
+      std::unordered_set<PackedGraph> forms;
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      for (int r = 0; r < kRepetitions; ++r) {
+        for (size_t i = 0; i < graphs.size(); ++i) {
+          forms.insert(workspace.GetCanonicalForm(GraphView(graphs[i])));
+        }
+      }
+      const double seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                        start)
+              .count();
+      canonizer->set_options(saved);
+      printf("  %-18s %10.1f us/graph %4zu classes\n", configurations[c].name,
+             seconds * 1e6 / (kRepetitions * graphs.size()), forms.size());
+    }
+  }
+  return 0;
+}
@@ -10,7 +10,9 @@
 #include <iostream>
 #include <fstream>
 
+#include "graph_utils/fixed_graph.h"
 #include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
 #include "graph_utils/graph_utilities.h"
 #include "graph_utils/graph_generator.h"
 #include "nauty_utils/nauty_wrapper.h"
@@ -18,7 +20,10 @@
 using std::vector;
 using std::queue;
 using graph_utils::SimpleGraphGenerator;
+using graph_utils::FixedOrderGenerator;
 using graph_utils::Graph;
+using graph_utils::GraphStore;
+using graph_utils::GraphView;
 using graph_utils::DiamondFreeGraph;
 using nauty_utils::IsomorphismChecker;
 
@@ -29,12 +34,12 @@ const char kExportFileName[] = "temp_diamond_free_10.txt";
 
 int64_t final_count = 0;
 
-void ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
+void ExportGraphsToFile(const string &filename, const GraphStore &graphs) {
   std::ofstream f;
   f.open(filename, std::ios::app);
   for (size_t i = 0; i < graphs.size(); ++i) {
     vector<string> matrix;
-    graphs[i]->GetAdjMatrix(&matrix);
+    graphs[i].GetAdjMatrix(&matrix);
     for (size_t j = 0; j < matrix.size(); ++j) {
       f << matrix[j] << std::endl;
     }
@@ -45,10 +50,13 @@ void ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
 }
 
 void ExportAllNonIsomorphicGraphsForSequence(const vector<int> &seq) {
-  vector<Graph *> all_graphs;
+  GraphStore all_graphs(seq.size());
   DiamondFreeGraph filter;
 
-  SimpleGraphGenerator::GenerateAllUniqueGraphs(seq, &filter, &all_graphs);
+  FixedOrderGenerator<DiamondFreeGraph> generator(seq, filter, &all_graphs);
+  if (!graph_utils::DispatchFixedGraphOrder(seq.size(), &generator)) {
+    SimpleGraphGenerator::GenerateAllUniqueGraphs(seq, &filter, &all_graphs);
+  }
   bool should_export = false;
   if (!all_graphs.empty()) {
     final_count += all_graphs.size();
@@ -58,11 +66,6 @@ void ExportAllNonIsomorphicGraphsForSequence(const vector<int> &seq) {
   if (should_export) {
     ExportGraphsToFile(kExportFileName, all_graphs);
   }
-
-  while (!all_graphs.empty()) {
-    delete all_graphs.back();
-    all_graphs.pop_back();
-  }
 }
 
 } // namespace
@@ -9,14 +9,19 @@
 #include <fstream>
 
 #include "graph_utils/girth_5_graph.h"
+#include "graph_utils/fixed_graph.h"
 #include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
 #include "graph_utils/graph_generator.h"
 #include "nauty_utils/nauty_wrapper.h"
 
 using std::vector;
 using std::queue;
 using graph_utils::SimpleGraphGenerator;
+using graph_utils::FixedOrderGenerator;
 using graph_utils::Graph;
+using graph_utils::GraphStore;
+using graph_utils::GraphView;
 using graph_utils::Girth5Graph;
 using nauty_utils::IsomorphismChecker;
 
@@ -27,7 +32,7 @@ const string kExportFileName = "girth_5_order_temp.txt";
 
 int64_t final_count = 0;
 
-bool IsGraphExtremal(const Graph &g) {
+bool IsGraphExtremal(const GraphView &g) {
   // Numbers taken from
   // http://www.dcs.gla.ac.uk/~pat/jchoco/extremal/papers/10.1.1.92.3502.pdf
   int kExtremalSizes[] = {0,  0,  1,  2,  3,  5,  6,  8,  10, 12, 15,
@@ -36,12 +41,13 @@ bool IsGraphExtremal(const Graph &g) {
   return kExtremalSizes[g.size()] == g.GetNumberOfEdges();
 }
 
-void ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
+void ExportGraphsToFile(const string &filename,
+                        const vector<GraphView> &graphs) {
   std::ofstream f;
   f.open(filename, std::ios::app);
   for (size_t i = 0; i < graphs.size(); ++i) {
     vector<string> matrix;
-    graphs[i]->GetAdjMatrix(&matrix);
+    graphs[i].GetAdjMatrix(&matrix);
     for (size_t j = 0; j < matrix.size(); ++j) {
       f << matrix[j] << std::endl;
     }
@@ -52,13 +58,16 @@ void ExportGraphsToFile(const string &filename, const vector<Graph *> &graphs) {
 }
 
 void ExportAllNonIsomorphicGraphsForSequence(const vector<int> &seq) {
-  vector<Graph *> all_graphs;
+  GraphStore all_graphs(seq.size());
   Girth5Graph filter;
-  SimpleGraphGenerator::GenerateAllUniqueGraphs(seq, &filter, &all_graphs);
+  FixedOrderGenerator<Girth5Graph> generator(seq, filter, &all_graphs);
+  if (!graph_utils::DispatchFixedGraphOrder(seq.size(), &generator)) {
+    SimpleGraphGenerator::GenerateAllUniqueGraphs(seq, &filter, &all_graphs);
+  }
   bool should_export = false;
-  vector<Graph *> extremal_graphs;
+  vector<GraphView> extremal_graphs;
   for (size_t i = 0; i < all_graphs.size(); ++i) {
-    if (IsGraphExtremal(*all_graphs[i])) {
+    if (IsGraphExtremal(all_graphs[i])) {
       extremal_graphs.push_back(all_graphs[i]);
     }
   }
@@ -70,11 +79,6 @@ void ExportAllNonIsomorphicGraphsForSequence(const vector<int> &seq) {
   if (should_export) {
     ExportGraphsToFile(kExportFileName, extremal_graphs);
   }
-
-  while (!all_graphs.empty()) {
-    delete all_graphs.back();
-    all_graphs.pop_back();
-  }
 }
 
 } // namespace
@@ -0,0 +1,315 @@
+// Implementation of CanonicalFormIndex.
+
+#include "canonical_form_index.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "canonizer.h"
+#include "graph_utils/graph_fingerprint.h"
+#include "nauty_wrapper.h"
+
+using graph_utils::Word;
+
+namespace nauty_utils {
+namespace {
+
+const char kMagic[8] = {'N', 'U', 'C', 'F', 'I', 'D', 'X', '1'};
+const uint32_t kVersion = 1;
+// The header takes the first page of the file.
+const size_t kHeaderBytes = 4096;
+
+// Set in every tag, so that a tag of 0 marks an empty slot.
+const uint64_t kUsedBit = 1ULL << 63;
+
+// Returns the tag of 'form': its hash, of which the directory uses the low
+// bits and the probing in a bucket the high ones.
+uint64_t GetTag(const PackedGraph &form) {
+  return graph_utils::MixBits(form.Hash()) | kUsedBit;
+}
+
+} // namespace
+
+struct CanonicalFormIndex::FileHeader {
+  char magic[8];
+  uint32_t version;
+  int32_t order;
+  uint64_t bucket_bytes;
+  uint64_t num_buckets;
+  uint64_t size;
+  // The name of the Canonizer the forms come from.
+  char canonizer[32];
+};
+
+struct CanonicalFormIndex::BucketHeader {
+  uint32_t local_depth;
+  uint32_t count;
+  // The low 'local_depth' bits of the tags of all forms in the bucket.
+  uint64_t prefix;
+};
+
+CanonicalFormIndex::CanonicalFormIndex()
+    : fd_(-1), order_(0), form_words_(0), slot_words_(0), bucket_bytes_(0),
+      slots_per_bucket_(0), max_load_(0), header_(NULL), mapped_bytes_(0),
+      capacity_(0), global_depth_(0) {}
+
+CanonicalFormIndex::~CanonicalFormIndex() { Close(); }
+
+bool CanonicalFormIndex::Open(const std::string &path, const int n) {
+  Close();
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    perror(path.c_str());
+    return false;
+  }
+  order_ = n;
+  form_words_ = PackedGraph::PackedWords(n);
+  slot_words_ = 1 + form_words_;
+  const size_t slot_bytes = slot_words_ * sizeof(uint64_t);
+  bucket_bytes_ = kBucketBytes;
+  while ((bucket_bytes_ - sizeof(BucketHeader)) / slot_bytes <
+         static_cast<size_t>(kMinSlotsPerBucket)) {
+    bucket_bytes_ += kBucketBytes;
+  }
+  slots_per_bucket_ = (bucket_bytes_ - sizeof(BucketHeader)) / slot_bytes;
+  // Three quarters full keeps the probe sequences short.
+  max_load_ = std::max(1, slots_per_bucket_ * 3 / 4);
+
+  const char *canonizer = GetDefaultCanonizer()->name();
+  struct stat st;
+  fstat(fd_, &st);
+  const bool is_new = st.st_size == 0;
+  if (!is_new && st.st_size < static_cast<off_t>(kHeaderBytes)) {
+    fprintf(stderr, "%s is not a canonical form index.\n", path.c_str());
+    Close();
+    return false;
+  }
+  const size_t capacity =
+      is_new ? 1 : (st.st_size - kHeaderBytes) / bucket_bytes_;
+  if (!Map(capacity)) {
+    Close();
+    return false;
+  }
+  if (is_new) {
+    memcpy(header_->magic, kMagic, sizeof(kMagic));
+    header_->version = kVersion;
+    header_->order = n;
+    header_->bucket_bytes = bucket_bytes_;
+    header_->num_buckets = 0;
+    header_->size = 0;
+    strncpy(header_->canonizer, canonizer, sizeof(header_->canonizer) - 1);
+    AddBucket();
+    global_depth_ = 0;
+    directory_.assign(1, 0);
+    return true;
+  }
+  if (memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header_->version != kVersion || header_->order != n ||
+      header_->bucket_bytes != bucket_bytes_ ||
+      strncmp(header_->canonizer, canonizer, sizeof(header_->canonizer)) !=
+          0) {
+    fprintf(stderr,
+            "%s is not a canonical form index of order %d by the %s "
+            "canonizer.\n",
+            path.c_str(), n, canonizer);
+    Close();
+    return false;
+  }
+  // The directory is rebuilt from the depths and prefixes of the buckets.
+  global_depth_ = 0;
+  for (size_t b = 0; b < header_->num_buckets; ++b) {
+    global_depth_ =
+        std::max(global_depth_, static_cast<int>(GetBucket(b)->local_depth));
+  }
+  directory_.assign(size_t(1) << global_depth_, 0);
+  for (size_t b = 0; b < header_->num_buckets; ++b) {
+    const BucketHeader *bucket = GetBucket(b);
+    for (size_t i = bucket->prefix; i < directory_.size();
+         i += size_t(1) << bucket->local_depth) {
+      directory_[i] = b;
+    }
+  }
+  return true;
+}
+
+void CanonicalFormIndex::Close() {
+  if (header_ != NULL) {
+    const size_t used = kHeaderBytes + header_->num_buckets * bucket_bytes_;
+    munmap(header_, mapped_bytes_);
+    header_ = NULL;
+    // The unused buckets at the end are cut off, unless the file was not
+    // opened as an index (the directory is set once it is).
+    if (!directory_.empty() && ftruncate(fd_, used) != 0) {
+      perror("ftruncate");
+    }
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  mapped_bytes_ = 0;
+  capacity_ = 0;
+  directory_.clear();
+}
+
+size_t CanonicalFormIndex::size() const {
+  return header_ == NULL ? 0 : header_->size;
+}
+
+size_t CanonicalFormIndex::num_buckets() const {
+  return header_ == NULL ? 0 : header_->num_buckets;
+}
+
+bool CanonicalFormIndex::Insert(const PackedGraph &form) {
+  const uint64_t tag = GetTag(form);
+  while (true) {
+    const size_t b = directory_[tag & (directory_.size() - 1)];
+    BucketHeader *bucket = GetBucket(b);
+    uint64_t *slot = FindSlot(bucket, tag, form.data());
+    if (*slot != 0) {
+      return false;
+    }
+    if (static_cast<int>(bucket->count) >= max_load_) {
+      SplitBucket(b);
+      continue;
+    }
+    slot[0] = tag;
+    memcpy(slot + 1, form.data(), form_words_ * sizeof(Word));
+    ++bucket->count;
+    ++header_->size;
+    return true;
+  }
+}
+
+bool CanonicalFormIndex::Contains(const PackedGraph &form) const {
+  const uint64_t tag = GetTag(form);
+  const BucketHeader *bucket =
+      GetBucket(directory_[tag & (directory_.size() - 1)]);
+  return *FindSlot(bucket, tag, form.data()) != 0;
+}
+
+bool CanonicalFormIndex::AddGraphToCheck(const GraphView &g) {
+  return Insert(IsomorphismChecker::GetCanonicalForm(g));
+}
+
+bool CanonicalFormIndex::AddGraphToCheck(const Graph &g) {
+  return Insert(IsomorphismChecker::GetCanonicalForm(g));
+}
+
+void CanonicalFormIndex::Sync() {
+  if (header_ != NULL) {
+    msync(header_, mapped_bytes_, MS_SYNC);
+  }
+}
+
+bool CanonicalFormIndex::Map(const size_t capacity) {
+  const size_t bytes = kHeaderBytes + capacity * bucket_bytes_;
+  if (header_ != NULL) {
+    munmap(header_, mapped_bytes_);
+    header_ = NULL;
+  }
+  struct stat st;
+  fstat(fd_, &st);
+  if (static_cast<size_t>(st.st_size) < bytes &&
+      ftruncate(fd_, bytes) != 0) {
+    perror("ftruncate");
+    return false;
+  }
+  void *mapping =
+      mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED) {
+    perror("mmap");
+    return false;
+  }
+  header_ = static_cast<FileHeader *>(mapping);
+  mapped_bytes_ = bytes;
+  capacity_ = capacity;
+  return true;
+}
+
+CanonicalFormIndex::BucketHeader *
+CanonicalFormIndex::GetBucket(const size_t b) const {
+  return reinterpret_cast<BucketHeader *>(reinterpret_cast<char *>(header_) +
+                                          kHeaderBytes + b * bucket_bytes_);
+}
+
+uint64_t *CanonicalFormIndex::GetSlot(const BucketHeader *bucket,
+                                      const int slot) const {
+  uint64_t *slots = reinterpret_cast<uint64_t *>(
+      const_cast<BucketHeader *>(bucket) + 1);
+  return slots + slot * slot_words_;
+}
+
+uint64_t *CanonicalFormIndex::FindSlot(const BucketHeader *bucket,
+                                       const uint64_t tag,
+                                       const Word *form) const {
+  // The buckets are never full, so the probing ends at an empty slot.
+  int i = (tag >> 32) % slots_per_bucket_;
+  while (true) {
+    uint64_t *slot = GetSlot(bucket, i);
+    if (slot[0] == 0 ||
+        (slot[0] == tag &&
+         memcmp(slot + 1, form, form_words_ * sizeof(Word)) == 0)) {
+      return slot;
+    }
+    if (++i == slots_per_bucket_) {
+      i = 0;
+    }
+  }
+}
+
+size_t CanonicalFormIndex::AddBucket() {
+  const size_t b = header_->num_buckets;
+  if (b == capacity_ && !Map(std::max<size_t>(1, 2 * capacity_))) {
+    // Running out of disk or address space leaves nothing sensible to do.
+    abort();
+  }
+  memset(GetBucket(b), 0, bucket_bytes_);
+  ++header_->num_buckets;
+  return b;
+}
+
+void CanonicalFormIndex::SplitBucket(const size_t b) {
+  const int depth = GetBucket(b)->local_depth;
+  if (depth == global_depth_) {
+    // The directory doubles; both halves point to the same buckets.
+    directory_.insert(directory_.end(), directory_.begin(), directory_.end());
+    ++global_depth_;
+  }
+  // Adding the bucket may move the mapping.
+  const size_t new_b = AddBucket();
+  BucketHeader *bucket = GetBucket(b);
+  BucketHeader *new_bucket = GetBucket(new_b);
+  const uint64_t bit = 1ULL << depth;
+  for (size_t i = 0; i < directory_.size(); ++i) {
+    if (directory_[i] == b && (i & bit) != 0) {
+      directory_[i] = new_b;
+    }
+  }
+  // The forms are taken out of the bucket and put back into one of the two.
+  std::vector<uint64_t> slots(GetSlot(bucket, 0),
+                              GetSlot(bucket, slots_per_bucket_));
+  memset(GetSlot(bucket, 0), 0, slots.size() * sizeof(uint64_t));
+  bucket->count = 0;
+  bucket->local_depth = depth + 1;
+  new_bucket->local_depth = depth + 1;
+  new_bucket->prefix = bucket->prefix | bit;
+  for (size_t s = 0; s < slots.size(); s += slot_words_) {
+    const uint64_t tag = slots[s];
+    if (tag == 0) {
+      continue;
+    }
+    BucketHeader *target = (tag & bit) != 0 ? new_bucket : bucket;
+    uint64_t *slot = FindSlot(target, tag, &slots[s + 1]);
+    memcpy(slot, &slots[s], slot_words_ * sizeof(uint64_t));
+    ++target->count;
+  }
+}
+
+} // namespace nauty_utils
@@ -0,0 +1,114 @@
+// A set of canonical forms kept in a memory-mapped file, for levels of the
+// generation that do not fit in memory. Only a small directory is kept on the
+// heap; the forms themselves live in the page cache, which the kernel writes
+// back and evicts as it needs to. The file can be opened again by later runs,
+// so a set built once can be queried afterwards.
+//
+// The file is an extendible hash table: it holds buckets of a fixed size, each
+// an open-addressing table of forms with linear probing. The directory maps the
+// low bits of the hash of a form to its bucket. A bucket that fills up is split
+// in two by the next bit of the hash, so the table grows a bucket at a time
+// and no insertion ever rehashes more than a single bucket. The directory is
+// not stored but rebuilt from the bucket headers when the file is opened.
+//
+// An index must not be used by several threads at once.
+
+#ifndef NAUTY_UTILS_CANONICAL_FORM_INDEX_H_
+#define NAUTY_UTILS_CANONICAL_FORM_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
+#include "graph_utils/packed_graph.h"
+
+namespace nauty_utils {
+
+using graph_utils::Graph;
+using graph_utils::GraphView;
+using graph_utils::PackedGraph;
+
+class CanonicalFormIndex {
+public:
+  // The smallest bucket, one page. Buckets of large orders are larger, so
+  // that they hold at least kMinSlotsPerBucket forms.
+  static const size_t kBucketBytes = 4096;
+  static const int kMinSlotsPerBucket = 8;
+
+  CanonicalFormIndex();
+  ~CanonicalFormIndex();
+
+  // Opens the index in the file 'path' for graphs of order 'n', creating it if
+  // it does not exist. Returns false if the file cannot be opened or mapped,
+  // or holds an index of another order or of forms of another Canonizer.
+  bool Open(const std::string &path, const int n);
+  // Writes all changes back and closes the file. Called by the destructor.
+  void Close();
+  bool is_open() const { return header_ != NULL; }
+
+  int order() const { return order_; }
+  // The number of forms in the index.
+  size_t size() const;
+  size_t num_buckets() const;
+
+  // Adds 'form', which must be of order(), and returns true if it was not in
+  // the index before.
+  bool Insert(const PackedGraph &form);
+  bool Contains(const PackedGraph &form) const;
+
+  // Adds the canonical form of 'g' by the default Canonizer, which must be
+  // the one the index was created with. Returns true if no graph isomorphic to
+  // 'g' was added before.
+  bool AddGraphToCheck(const GraphView &g);
+  bool AddGraphToCheck(const Graph &g);
+
+  // Writes all changes back to the file.
+  void Sync();
+
+private:
+  struct FileHeader;
+  struct BucketHeader;
+
+  CanonicalFormIndex(const CanonicalFormIndex &);
+  CanonicalFormIndex &operator=(const CanonicalFormIndex &);
+
+  // Maps the first 'capacity' buckets of the file, growing the file if needed.
+  bool Map(const size_t capacity);
+  // Returns the header of bucket 'b'; its slots follow it.
+  BucketHeader *GetBucket(const size_t b) const;
+  uint64_t *GetSlot(const BucketHeader *bucket, const int slot) const;
+  // Returns the slot of 'form' with the given tag in 'bucket' if the form is
+  // there, and otherwise the empty slot it would go to.
+  uint64_t *FindSlot(const BucketHeader *bucket, const uint64_t tag,
+                     const graph_utils::Word *form) const;
+  // Appends a new bucket to the file and returns its number.
+  size_t AddBucket();
+  // Splits the full bucket 'b' in two by the next bit of the hash.
+  void SplitBucket(const size_t b);
+
+  int fd_;
+  int order_;
+  // The words of a packed form, and of a slot: a tag and the form.
+  int form_words_;
+  int slot_words_;
+  size_t bucket_bytes_;
+  int slots_per_bucket_;
+  // A bucket is split when a new form would take it past this many forms.
+  int max_load_;
+  // The mapping of the file, which starts with the header.
+  FileHeader *header_;
+  size_t mapped_bytes_;
+  // The number of buckets mapped, some of them unused.
+  size_t capacity_;
+  // directory_[h & (2^global_depth_ - 1)] is the bucket of hash h.
+  int global_depth_;
+  std::vector<uint32_t> directory_;
+};
+
+} // namespace nauty_utils
+
+#endif // NAUTY_UTILS_CANONICAL_FORM_INDEX_H_
@@ -0,0 +1,122 @@
+// Unit tests for CanonicalFormIndex.
+
+#include "canonical_form_index.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "graph_utils/graph.h"
+#include "graph_utils/packed_graph.h"
+#include "graph_utils/test_graphs.h"
+#include "gtest/gtest.h"
+
+using graph_utils::Graph;
+using graph_utils::PackedGraph;
+using std::string;
+using std::vector;
+
+namespace nauty_utils {
+namespace {
+
+// Returns a path for an index file of the test that does not exist yet.
+string GetTestFileName(const string &name) {
+  const string path =
+      "/tmp/canonical_form_index_test_" + std::to_string(getpid()) + "_" + name;
+  remove(path.c_str());
+  return path;
+}
+
+// Returns a pseudo-random graph of order 'n', packed.
+PackedGraph GetRandomGraph(const int n, const unsigned seed) {
+  Graph g(n);
+  graph_utils::AddRandomEdges(seed, 2, &g);
+  return PackedGraph(g);
+}
+
+} // namespace
+
+TEST(CanonicalFormIndexTest, InsertAndContains) {
+  const string path = GetTestFileName("insert");
+  const int n = 12;
+  CanonicalFormIndex index;
+  ASSERT_TRUE(index.Open(path, n));
+  EXPECT_EQ(0, index.size());
+  // The empty graph is all zeros, which must not look like an empty slot.
+  EXPECT_FALSE(index.Contains(PackedGraph(Graph(n))));
+  EXPECT_TRUE(index.Insert(PackedGraph(Graph(n))));
+  EXPECT_TRUE(index.Contains(PackedGraph(Graph(n))));
+
+  std::set<PackedGraph> expected;
+  expected.insert(PackedGraph(Graph(n)));
+  // Every graph is drawn twice, and the buckets are split many times.
+  for (int i = 0; i < 100000; ++i) {
+    const PackedGraph g = GetRandomGraph(n, i / 2);
+    EXPECT_EQ(expected.insert(g).second, index.Insert(g));
+  }
+  EXPECT_EQ(expected.size(), index.size());
+  EXPECT_LT(1, index.num_buckets());
+  for (std::set<PackedGraph>::const_iterator it = expected.begin();
+       it != expected.end(); ++it) {
+    ASSERT_TRUE(index.Contains(*it));
+  }
+  // The complete graph, which is never drawn.
+  Graph complete(n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = i + 1; j < n; ++j) {
+      complete.AddEdge(i, j);
+    }
+  }
+  EXPECT_FALSE(index.Contains(PackedGraph(complete)));
+  index.Close();
+  remove(path.c_str());
+}
+
+TEST(CanonicalFormIndexTest, Reopen) {
+  const string path = GetTestFileName("reopen");
+  const int n = 70;
+  vector<PackedGraph> graphs;
+  for (int i = 0; i < 2000; ++i) {
+    graphs.push_back(GetRandomGraph(n, 7 + i));
+  }
+  {
+    CanonicalFormIndex index;
+    ASSERT_TRUE(index.Open(path, n));
+    for (size_t i = 0; i < graphs.size() / 2; ++i) {
+      EXPECT_TRUE(index.Insert(graphs[i]));
+    }
+  }
+  CanonicalFormIndex index;
+  // The file holds an index of another order.
+  EXPECT_FALSE(index.Open(path, n - 1));
+  EXPECT_FALSE(index.is_open());
+  ASSERT_TRUE(index.Open(path, n));
+  EXPECT_EQ(graphs.size() / 2, index.size());
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    EXPECT_EQ(i < graphs.size() / 2, index.Contains(graphs[i]));
+    EXPECT_EQ(i >= graphs.size() / 2, index.Insert(graphs[i]));
+  }
+  EXPECT_EQ(graphs.size(), index.size());
+  index.Close();
+  remove(path.c_str());
+}
+
+TEST(CanonicalFormIndexTest, AddGraphToCheck) {
+  const string path = GetTestFileName("check");
+  CanonicalFormIndex index;
+  ASSERT_TRUE(index.Open(path, 4));
+  vector<string> path1({"0110", "1000", "1001", "0010"});
+  vector<string> path2({"0100", "1010", "0101", "0010"});
+  vector<string> star({"0111", "1000", "1000", "1000"});
+  EXPECT_TRUE(index.AddGraphToCheck(Graph(path1)));
+  EXPECT_FALSE(index.AddGraphToCheck(GraphView(Graph(path2))));
+  EXPECT_TRUE(index.AddGraphToCheck(Graph(star)));
+  EXPECT_EQ(2, index.size());
+  index.Close();
+  remove(path.c_str());
+}
+
+} // namespace nauty_utils
@@ -0,0 +1,454 @@
+// Implementation of the canonisation engines.
+
+#include "canonizer.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "nauty/nausparse.h"
+#include "nauty/nautinv.h"
+#include "nauty/nauty.h"
+#include "nauty/traces.h"
+#include "nauty_graph.h"
+
+namespace nauty_utils {
+namespace {
+
+// Sets 'sg' to the rows of 'g' as adjacency lists. The lists are kept by the
+// calling thread until its next call.
+void ToSparseGraph(const GraphView &g, sparsegraph *sg) {
+  DYNALLSTAT(size_t, v, v_sz);
+  DYNALLSTAT(int, d, d_sz);
+  DYNALLSTAT(int, e, e_sz);
+
+  const int n = g.size();
+  const int m = g.words_per_row();
+  const size_t num_arcs = 2 * static_cast<size_t>(g.GetNumberOfEdges());
+  DYNALLOC1(size_t, v, v_sz, n, "malloc");
+  DYNALLOC1(int, d, d_sz, n, "malloc");
+  DYNALLOC1(int, e, e_sz, num_arcs, "malloc");
+
+  size_t pos = 0;
+  for (int u = 0; u < n; ++u) {
+    v[u] = pos;
+    const Word *row = g.GetRow(u);
+    for (int w = 0; w < m; ++w) {
+      Word bits = row[w];
+      while (bits) {
+        e[pos++] =
+            w * graph_utils::kWordSize + graph_utils::TakeFirstBit(&bits);
+      }
+    }
+    d[u] = pos - v[u];
+  }
+
+  SG_INIT(*sg);
+  sg->nv = n;
+  sg->nde = num_arcs;
+  sg->v = v;
+  sg->vlen = n;
+  sg->d = d;
+  sg->dlen = n;
+  sg->e = e;
+  sg->elen = num_arcs;
+}
+
+// Stores the sparse graph 'sg' as rows into 'canonical'.
+void FromSparseGraph(sparsegraph *sg, Word *canonical) {
+  int m = SETWORDSNEEDED(sg->nv);
+  sg_to_nauty(sg, reinterpret_cast<graph *>(canonical), m, &m);
+}
+
+// Stores the initial colouring of 'g' under 'options' into 'lab' and 'ptn', in
+// the format of nauty and Traces: the cells in the order of their colours, each
+// ended by a 0 in 'ptn'. Returns false if there is a colouring, and true if the
+// engine is to start from a single cell (its defaultptn).
+bool SetInitialColouring(const GraphView &g, const CanonisationOptions &options,
+                         int *lab, int *ptn) {
+  const int n = g.size();
+  if (options.colouring == kNoColouring || n == 0) {
+    return true;
+  }
+  std::vector<int> colours(n);
+  if (options.colouring == kColourByDegree) {
+    for (int v = 0; v < n; ++v) {
+      colours[v] = g.Degree(v);
+    }
+  } else {
+    options.colour_vertices(g, &colours);
+  }
+  for (int v = 0; v < n; ++v) {
+    lab[v] = v;
+  }
+  std::sort(lab, lab + n, [&colours](const int u, const int v) {
+    return colours[u] < colours[v] || (colours[u] == colours[v] && u < v);
+  });
+  for (int i = 0; i < n - 1; ++i) {
+    ptn[i] = colours[lab[i]] == colours[lab[i + 1]] ? 1 : 0;
+  }
+  ptn[n - 1] = 0;
+  return false;
+}
+
+// A vertex invariant, as the invarproc of nauty's options.
+typedef void (*InvariantProc)(graph *, int *, int *, int, int, int, int *, int,
+                              boolean, int, int);
+
+// Returns the nautinv.c procedure of 'invariant', or NULL for kNoInvariant.
+InvariantProc GetDenseInvariant(const VertexInvariant invariant) {
+  switch (invariant) {
+  case kAdjacencies:
+    return adjacencies;
+  case kAdjTriang:
+    return adjtriang;
+  case kCellQuads:
+    return cellquads;
+  case kCellCliques:
+    return cellcliq;
+  case kDistances:
+    return distances;
+  case kQuadruples:
+    return quadruples;
+  case kTriples:
+    return triples;
+  case kTwoPaths:
+    return twopaths;
+  default:
+    return NULL;
+  }
+}
+
+// Returns the procedure of 'invariant' for sparse graphs, or NULL if there is
+// none.
+InvariantProc GetSparseInvariant(const VertexInvariant invariant) {
+  switch (invariant) {
+  case kAdjacencies:
+    return adjacencies_sg;
+  case kDistances:
+    return distances_sg;
+  default:
+    return NULL;
+  }
+}
+
+// Makes nauty use 'invariant' as 'options' say, if it is not NULL.
+void SetInvariant(const CanonisationOptions &options,
+                  const InvariantProc invariant, optionblk *nauty_options) {
+  if (invariant == NULL) {
+    return;
+  }
+  nauty_options->invarproc = invariant;
+  nauty_options->mininvarlevel = options.min_invariant_level;
+  nauty_options->maxinvarlevel = options.max_invariant_level;
+  nauty_options->invararg = options.invariant_arg;
+}
+
+// The generators found by the engine running on the calling thread are appended
+// to this, unless it is NULL.
+static TLS_ATTR std::vector<std::vector<int> > *collected_generators = NULL;
+
+// The userautomproc of nauty, which is called for every generator.
+void CollectGenerator(int count, int *perm, int *orbits, int num_orbits,
+                      int stabilised_vertex, int n) {
+  collected_generators->push_back(std::vector<int>(perm, perm + n));
+}
+
+// The userautomproc of Traces.
+void CollectTracesGenerator(int count, int *perm, int n) {
+  collected_generators->push_back(std::vector<int>(perm, perm + n));
+}
+
+// Prepares 'group' for a graph of order 'n' and makes the engine collect its
+// generators, if 'group' is not NULL. Returns the array the orbits are to be
+// stored into, which is 'orbits' if 'group' is NULL.
+int *StartGroup(const int n, int *orbits, AutomorphismGroup *group) {
+  if (group == NULL) {
+    return orbits;
+  }
+  group->orbits.resize(n);
+  group->generators.clear();
+  collected_generators = &group->generators;
+  return group->orbits.data();
+}
+
+// Stores the size of the group and stops collecting its generators.
+void FinishGroup(const int num_orbits, const double group_size,
+                 const int group_size_exponent, AutomorphismGroup *group) {
+  if (group == NULL) {
+    return;
+  }
+  group->num_orbits = num_orbits;
+  group->group_size = group_size;
+  group->group_size_exponent = group_size_exponent;
+  collected_generators = NULL;
+}
+
+// Returns a new cache key. Keys start at 1, since 0 means no key to Graph.
+uint64_t NextCacheKey() {
+  static std::atomic<uint64_t> last_key(0);
+  return last_key.fetch_add(1) + 1;
+}
+
+// The Canonizer returned by GetDefaultCanonizer(), once it is known.
+std::atomic<Canonizer *> *DefaultCanonizer() {
+  static std::atomic<Canonizer *> canonizer(nullptr);
+  return &canonizer;
+}
+
+} // namespace
+
+double AutomorphismGroup::GetGroupSize() const {
+  return group_size * pow(10.0, group_size_exponent);
+}
+
+double AutomorphismGroup::CountLabelledGraphs() const {
+  // In logarithms, since n! overflows long before n / |Aut(g)| does.
+  const double log_count = lgamma(lab.size() + 1.0) - log(group_size) -
+                           group_size_exponent * log(10.0);
+  return floor(exp(log_count) + 0.5);
+}
+
+Canonizer::Canonizer()
+    : cache_key_(NextCacheKey()), num_calls_(0), nanoseconds_(0) {}
+
+void Canonizer::set_options(const CanonisationOptions &options) {
+  options_ = options;
+  cache_key_ = NextCacheKey();
+}
+
+void Canonizer::Canonise(const GraphView &g, int *lab, Word *canonical,
+                         int *orbits) {
+  Run(g, options_, lab, canonical, orbits, NULL);
+}
+
+void Canonizer::GetAutomorphismGroup(const GraphView &g,
+                                     AutomorphismGroup *group) {
+  const int n = g.size();
+  group->lab.resize(n);
+  group->canonical.assign(n * graph_utils::WordsNeeded(n), 0);
+  // The group of the empty graph, which the engines skip.
+  group->num_orbits = 0;
+  group->group_size = 1;
+  group->group_size_exponent = 0;
+  Run(g, options_, group->lab.data(), group->canonical.data(), NULL, group);
+}
+
+void Canonizer::Run(const GraphView &g, const CanonisationOptions &options,
+                    int *lab, Word *canonical, int *orbits,
+                    AutomorphismGroup *group) {
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  DoCanonise(g, options, lab, canonical, orbits, group);
+  const long long elapsed =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+  num_calls_.fetch_add(1, std::memory_order_relaxed);
+  nanoseconds_.fetch_add(elapsed, std::memory_order_relaxed);
+}
+
+void Canonizer::ResetStats() {
+  num_calls_.store(0);
+  nanoseconds_.store(0);
+}
+
+void DenseNautyCanonizer::DoCanonise(const GraphView &g,
+                                     const CanonisationOptions &options,
+                                     int *lab, Word *canonical, int *orbits,
+                                     AutomorphismGroup *group) {
+  DYNALLSTAT(int, ptn, ptn_sz);
+  DYNALLSTAT(int, orbit_buffer, orbit_buffer_sz);
+
+  DEFAULTOPTIONS_GRAPH(nauty_options);
+  statsblk stats;
+  nauty_options.getcanon = TRUE;
+  SetInvariant(options, GetDenseInvariant(options.invariant), &nauty_options);
+
+  // nauty is checked once per thread; m and n are not checked by it when
+  // nauty is built with MAXN = 0.
+  static TLS_ATTR boolean checked = FALSE;
+  int n = g.size();
+  int m = SETWORDSNEEDED(n);
+  if (!checked) {
+    nauty_check(WORDSIZE, m, n, NAUTYVERSIONID);
+    checked = TRUE;
+  }
+
+  // The buffers are kept between calls.
+  DYNALLOC1(int, ptn, ptn_sz, n, "malloc");
+  DYNALLOC1(int, orbit_buffer, orbit_buffer_sz, n, "malloc");
+
+  nauty_options.defaultptn = SetInitialColouring(g, options, lab, ptn);
+  if (group != NULL) {
+    nauty_options.userautomproc = CollectGenerator;
+  }
+  int *orbits_out =
+      StartGroup(n, orbits != NULL ? orbits : orbit_buffer, group);
+  // The rows of the graph are a nauty graph already.
+  densenauty(AsNautyGraph(g), lab, ptn, orbits_out, &nauty_options, &stats, m,
+             n, reinterpret_cast<graph *>(canonical));
+  FinishGroup(stats.numorbits, stats.grpsize1, stats.grpsize2, group);
+}
+
+void SparseNautyCanonizer::DoCanonise(const GraphView &g,
+                                      const CanonisationOptions &options,
+                                      int *lab, Word *canonical, int *orbits,
+                                      AutomorphismGroup *group) {
+  DYNALLSTAT(int, ptn, ptn_sz);
+  DYNALLSTAT(int, orbit_buffer, orbit_buffer_sz);
+  static TLS_ATTR SG_DECL(canonical_sg);
+
+  DEFAULTOPTIONS_SPARSEGRAPH(nauty_options);
+  statsblk stats;
+  nauty_options.getcanon = TRUE;
+  SetInvariant(options, GetSparseInvariant(options.invariant), &nauty_options);
+
+  const int n = g.size();
+  if (n == 0) {
+    return;
+  }
+  DYNALLOC1(int, ptn, ptn_sz, n, "malloc");
+  DYNALLOC1(int, orbit_buffer, orbit_buffer_sz, n, "malloc");
+
+  nauty_options.defaultptn = SetInitialColouring(g, options, lab, ptn);
+  if (group != NULL) {
+    nauty_options.userautomproc = CollectGenerator;
+  }
+  sparsegraph sg;
+  ToSparseGraph(g, &sg);
+  int *orbits_out =
+      StartGroup(n, orbits != NULL ? orbits : orbit_buffer, group);
+  sparsenauty(&sg, lab, ptn, orbits_out, &nauty_options, &stats,
+              &canonical_sg);
+  FinishGroup(stats.numorbits, stats.grpsize1, stats.grpsize2, group);
+  FromSparseGraph(&canonical_sg, canonical);
+}
+
+void TracesCanonizer::DoCanonise(const GraphView &g,
+                                 const CanonisationOptions &options, int *lab,
+                                 Word *canonical, int *orbits,
+                                 AutomorphismGroup *group) {
+  DYNALLSTAT(int, ptn, ptn_sz);
+  DYNALLSTAT(int, orbit_buffer, orbit_buffer_sz);
+  static TLS_ATTR SG_DECL(canonical_sg);
+
+  // Traces has no vertex invariants.
+  DEFAULTOPTIONS_TRACES(traces_options);
+  TracesStats stats;
+  traces_options.getcanon = TRUE;
+
+  const int n = g.size();
+  if (n == 0) {
+    return;
+  }
+  DYNALLOC1(int, ptn, ptn_sz, n, "malloc");
+  DYNALLOC1(int, orbit_buffer, orbit_buffer_sz, n, "malloc");
+
+  traces_options.defaultptn = SetInitialColouring(g, options, lab, ptn);
+  if (group != NULL) {
+    traces_options.userautomproc = CollectTracesGenerator;
+  }
+  sparsegraph sg;
+  ToSparseGraph(g, &sg);
+  int *orbits_out =
+      StartGroup(n, orbits != NULL ? orbits : orbit_buffer, group);
+  Traces(&sg, lab, ptn, orbits_out, &traces_options, &stats, &canonical_sg);
+  FinishGroup(stats.numorbits, stats.grpsize1, stats.grpsize2, group);
+  FromSparseGraph(&canonical_sg, canonical);
+}
+
+CanonizerType AutoCanonizer::Select(const int n, const long long num_edges) {
+  if (n <= kMaxDenseOrder ||
+      num_edges >= kMinDensity * (n * (n - 1LL) / 2)) {
+    return kDenseNauty;
+  }
+  return n >= kMinTracesOrder ? kTraces : kSparseNauty;
+}
+
+void AutoCanonizer::DoCanonise(const GraphView &g,
+                               const CanonisationOptions &options, int *lab,
+                               Word *canonical, int *orbits,
+                               AutomorphismGroup *group) {
+  // The edges of small graphs need not be counted.
+  const CanonizerType type =
+      g.size() <= kMaxDenseOrder ? kDenseNauty
+                                 : Select(g.size(), g.GetNumberOfEdges());
+  GetCanonizer(type)->Run(g, options, lab, canonical, orbits, group);
+}
+
+Canonizer *GetCanonizer(const CanonizerType type) {
+  static DenseNautyCanonizer dense;
+  static SparseNautyCanonizer sparse;
+  static TracesCanonizer traces;
+  static AutoCanonizer automatic;
+  switch (type) {
+  case kDenseNauty:
+    return &dense;
+  case kSparseNauty:
+    return &sparse;
+  case kTraces:
+    return &traces;
+  default:
+    return &automatic;
+  }
+}
+
+bool ParseCanonizerType(const std::string &name, CanonizerType *type) {
+  if (name == "dense") {
+    *type = kDenseNauty;
+  } else if (name == "sparse") {
+    *type = kSparseNauty;
+  } else if (name == "traces") {
+    *type = kTraces;
+  } else if (name == "auto") {
+    *type = kAutoCanonizer;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+Canonizer *GetDefaultCanonizer() {
+  Canonizer *canonizer = DefaultCanonizer()->load(std::memory_order_relaxed);
+  if (canonizer == nullptr) {
+    CanonizerType type = kAutoCanonizer;
+    const char *name = getenv("NAUTY_UTILS_CANONIZER");
+    if (name != nullptr && !ParseCanonizerType(name, &type)) {
+      fprintf(stderr, "Unknown NAUTY_UTILS_CANONIZER '%s', using 'auto'.\n",
+              name);
+    }
+    canonizer = GetCanonizer(type);
+    DefaultCanonizer()->store(canonizer);
+  }
+  return canonizer;
+}
+
+void SetDefaultCanonizer(const CanonizerType type) {
+  DefaultCanonizer()->store(GetCanonizer(type));
+}
+
+void SetDefaultCanonisationOptions(const CanonisationOptions &options) {
+  const CanonizerType types[] = {kDenseNauty, kSparseNauty, kTraces,
+                                 kAutoCanonizer};
+  for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+    GetCanonizer(types[i])->set_options(options);
+  }
+}
+
+void PrintCanonizerStats(FILE *out) {
+  const CanonizerType types[] = {kDenseNauty, kSparseNauty, kTraces};
+  for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+    const Canonizer *canonizer = GetCanonizer(types[i]);
+    if (canonizer->num_calls() == 0) {
+      continue;
+    }
+    fprintf(out, "%-12s %12lld graphs %10.3f s %8.3f us/graph\n",
+            canonizer->name(), canonizer->num_calls(), canonizer->seconds(),
+            canonizer->seconds() * 1e6 / canonizer->num_calls());
+  }
+}
+
+} // namespace nauty_utils
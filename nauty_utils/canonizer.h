@@ -0,0 +1,243 @@
+// Canonisation engines. nauty ships three of them: dense nauty, which works on
+// adjacency rows and is the fastest for small and dense graphs; sparse nauty,
+// which works on adjacency lists; and Traces, which also works on adjacency
+// lists and is usually the fastest for large, sparse or hard graphs.
+//
+// Each engine is a Canonizer, which times its own calls. Different engines may
+// label the same graph differently, so all graphs that are compared with each
+// other must be canonised by the same Canonizer. The automatic one picks an
+// engine from the order and the number of edges of a graph only, which are the
+// same for isomorphic graphs, so it may be used like any other.
+
+#ifndef NAUTY_UTILS_CANONIZER_H_
+#define NAUTY_UTILS_CANONIZER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "graph_utils/bit_utils.h"
+#include "graph_utils/graph_store.h"
+
+namespace nauty_utils {
+
+using graph_utils::GraphView;
+using graph_utils::Word;
+
+// All an engine finds out about a graph g in one run: its canonical form and
+// its automorphism group Aut(g).
+struct AutomorphismGroup {
+  // The canonical labelling: vertex lab[i] of g is vertex i of its canonical
+  // form.
+  std::vector<int> lab;
+  // The canonical form, as n rows of WordsNeeded(n) words.
+  std::vector<Word> canonical;
+  // orbits[v] is the smallest vertex in the orbit of v under Aut(g).
+  std::vector<int> orbits;
+  int num_orbits;
+  // |Aut(g)| is group_size * 10^group_size_exponent. The exponent is 0 unless
+  // the size does not fit a double.
+  double group_size;
+  int group_size_exponent;
+  // Generators of Aut(g), each a permutation mapping v to generator[v].
+  std::vector<std::vector<int> > generators;
+
+  // Returns |Aut(g)|, which is infinite if it does not fit a double.
+  double GetGroupSize() const;
+  // Returns the number of labelled graphs isomorphic to g, n! / |Aut(g)|.
+  double CountLabelledGraphs() const;
+};
+
+// Vertex invariants of nautinv.c, which split the cells of the partition that
+// plain refinement cannot split. They pay off on highly regular graphs.
+enum VertexInvariant {
+  kNoInvariant,
+  kAdjacencies,
+  kAdjTriang,
+  kCellQuads,
+  kCellCliques,
+  kDistances,
+  kQuadruples,
+  kTriples,
+  kTwoPaths
+};
+
+// How the vertices are coloured before the search starts. Only vertices of the
+// same colour are mapped to each other.
+enum InitialColouring { kNoColouring, kColourByDegree, kCustomColouring };
+
+// The options of a Canonizer. The canonical form depends on them, so graphs
+// canonised with different options must not be compared, and a custom
+// colouring must be an isomorphism invariant (like the degree) for the forms
+// to decide isomorphism.
+struct CanonisationOptions {
+  CanonisationOptions()
+      : invariant(kNoInvariant), min_invariant_level(0),
+        max_invariant_level(1), invariant_arg(0), colouring(kNoColouring) {}
+
+  VertexInvariant invariant;
+  // The invariant is used at the levels of the search tree from
+  // min_invariant_level to max_invariant_level, where 1 is the root. As in
+  // nauty, a negative level means the invariant is used at that level only.
+  int min_invariant_level;
+  int max_invariant_level;
+  // Passed to the invariant (e.g. the maximum distance of kDistances).
+  int invariant_arg;
+
+  InitialColouring colouring;
+  // With kCustomColouring, stores a colour for each vertex of the graph.
+  std::function<void(const GraphView &, std::vector<int> *)> colour_vertices;
+};
+
+enum CanonizerType {
+  kDenseNauty,
+  kSparseNauty,
+  kTraces,
+  // Picks one of the above for every graph (see AutoCanonizer).
+  kAutoCanonizer
+};
+
+class Canonizer {
+public:
+  Canonizer();
+  virtual ~Canonizer() {}
+
+  virtual const char *name() const = 0;
+
+  // The options must not be changed while the Canonizer is in use. Traces
+  // uses no invariants, and sparse nauty only kAdjacencies and kDistances; the
+  // other invariants are ignored by them.
+  const CanonisationOptions &options() const { return options_; }
+  void set_options(const CanonisationOptions &options);
+
+  // Identifies the canonical forms of this Canonizer with its current options:
+  // no other Canonizer or set of options has the same key. Graphs cache their
+  // canonical forms under it (see Graph::CacheCanonicalForm()).
+  uint64_t cache_key() const { return cache_key_; }
+
+  // Stores the canonical labelling of 'g' into 'lab', which must hold n ints:
+  // vertex lab[i] of 'g' is vertex i of its canonical form. The canonical form
+  // is stored into 'canonical' as n rows of WordsNeeded(n) words. If 'orbits'
+  // is not NULL, orbits[v] is set to the smallest vertex in the orbit of v
+  // under Aut(g), which the engines find anyway. Safe to call from several
+  // threads at once, since nauty keeps a workspace per thread.
+  void Canonise(const GraphView &g, int *lab, Word *canonical,
+                int *orbits = NULL);
+
+  // Same as above, but everything nauty computes is stored into 'group'. The
+  // generators make this slower than Canonise().
+  void GetAutomorphismGroup(const GraphView &g, AutomorphismGroup *group);
+
+  // The number of calls to both methods above and the time they took, over all
+  // threads, since the Canonizer was created or the stats were reset.
+  long long num_calls() const { return num_calls_.load(); }
+  double seconds() const { return nanoseconds_.load() * 1e-9; }
+  void ResetStats();
+
+protected:
+  // Stores the canonical labelling and form of 'g' under 'options' into 'lab'
+  // and 'canonical', and its orbits into 'orbits' unless it is NULL. If
+  // 'group' is not NULL, all its fields are set instead of 'orbits'.
+  virtual void DoCanonise(const GraphView &g,
+                          const CanonisationOptions &options, int *lab,
+                          Word *canonical, int *orbits,
+                          AutomorphismGroup *group) = 0;
+
+private:
+  // Times DoCanonise(). AutoCanonizer runs the engines it picks through it,
+  // with its own options.
+  friend class AutoCanonizer;
+  void Run(const GraphView &g, const CanonisationOptions &options, int *lab,
+           Word *canonical, int *orbits, AutomorphismGroup *group);
+
+  Canonizer(const Canonizer &);
+  Canonizer &operator=(const Canonizer &);
+
+  CanonisationOptions options_;
+  uint64_t cache_key_;
+  std::atomic<long long> num_calls_;
+  std::atomic<long long> nanoseconds_;
+};
+
+class DenseNautyCanonizer final : public Canonizer {
+public:
+  virtual const char *name() const { return "dense nauty"; }
+
+protected:
+  virtual void DoCanonise(const GraphView &g,
+                          const CanonisationOptions &options, int *lab,
+                          Word *canonical, int *orbits,
+                          AutomorphismGroup *group);
+};
+
+class SparseNautyCanonizer final : public Canonizer {
+public:
+  virtual const char *name() const { return "sparse nauty"; }
+
+protected:
+  virtual void DoCanonise(const GraphView &g,
+                          const CanonisationOptions &options, int *lab,
+                          Word *canonical, int *orbits,
+                          AutomorphismGroup *group);
+};
+
+class TracesCanonizer final : public Canonizer {
+public:
+  virtual const char *name() const { return "Traces"; }
+
+protected:
+  virtual void DoCanonise(const GraphView &g,
+                          const CanonisationOptions &options, int *lab,
+                          Word *canonical, int *orbits,
+                          AutomorphismGroup *group);
+};
+
+// Hands every graph to the engine returned by Select(), whose stats count the
+// call as well.
+class AutoCanonizer final : public Canonizer {
+public:
+  // Graphs up to this order are always canonised by dense nauty.
+  static const int kMaxDenseOrder = 64;
+  // Graphs from this order on that are not dense are canonised by Traces.
+  static const int kMinTracesOrder = 200;
+  // Graphs with at least this share of all possible edges are dense.
+  static constexpr double kMinDensity = 0.25;
+
+  virtual const char *name() const { return "automatic"; }
+
+  // Returns the engine for graphs of order 'n' with 'num_edges' edges.
+  static CanonizerType Select(const int n, const long long num_edges);
+
+protected:
+  virtual void DoCanonise(const GraphView &g,
+                          const CanonisationOptions &options, int *lab,
+                          Word *canonical, int *orbits,
+                          AutomorphismGroup *group);
+};
+
+// Returns the process-wide Canonizer of the given type.
+Canonizer *GetCanonizer(const CanonizerType type);
+
+// Parses "dense", "sparse", "traces" or "auto" into 'type'. Returns false and
+// leaves 'type' as it is for any other name.
+bool ParseCanonizerType(const std::string &name, CanonizerType *type);
+
+// The Canonizer of IsomorphismChecker and everything built on it. It is the
+// one named by the environment variable NAUTY_UTILS_CANONIZER if that is set,
+// and the automatic one otherwise. It must not be changed while graphs are
+// being compared.
+Canonizer *GetDefaultCanonizer();
+void SetDefaultCanonizer(const CanonizerType type);
+// Sets the options of all process-wide Canonizers, under the same rules.
+void SetDefaultCanonisationOptions(const CanonisationOptions &options);
+
+// Prints the stats of every engine that was used to 'out'.
+void PrintCanonizerStats(FILE *out);
+
+} // namespace nauty_utils
+
+#endif // NAUTY_UTILS_CANONIZER_H_
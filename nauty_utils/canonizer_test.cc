@@ -0,0 +1,271 @@
+// Unit tests for the canonisation engines.
+
+#include "canonizer.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "graph_utils/graph.h"
+#include "graph_utils/packed_graph.h"
+#include "graph_utils/test_graphs.h"
+#include "gtest/gtest.h"
+#include "nauty_wrapper.h"
+
+using graph_utils::AddRandomEdges;
+using graph_utils::Graph;
+using graph_utils::PackedGraph;
+using graph_utils::Reverse;
+using graph_utils::WordSet;
+using graph_utils::WordsNeeded;
+using std::vector;
+
+namespace nauty_utils {
+namespace {
+
+const CanonizerType kAllTypes[] = {kDenseNauty, kSparseNauty, kTraces,
+                                   kAutoCanonizer};
+
+// Returns the options of the given invariant and colouring.
+CanonisationOptions GetOptions(const VertexInvariant invariant,
+                               const InitialColouring colouring) {
+  CanonisationOptions options;
+  options.invariant = invariant;
+  options.max_invariant_level = 2;
+  options.colouring = colouring;
+  return options;
+}
+
+// Returns the canonical form of 'g' by the given engine, packed, after checking
+// that it is 'g' relabelled by the canonical labelling.
+PackedGraph Canonise(const CanonizerType type, const Graph &g) {
+  const int n = g.size();
+  const int m = WordsNeeded(n);
+  vector<int> lab(n);
+  WordSet canonical(n * m);
+  GetCanonizer(type)->Canonise(GraphView(g), lab.data(), canonical.data());
+  vector<int> sorted(lab);
+  std::sort(sorted.begin(), sorted.end());
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(i, sorted[i]);
+  }
+  const GraphView form(n, canonical.data());
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      EXPECT_EQ(g.HasEdge(lab[i], lab[j]), form.HasEdge(i, j));
+    }
+  }
+  return PackedGraph(n, canonical.data());
+}
+
+// Returns true if 'perm' is an automorphism of 'g'.
+bool IsAutomorphism(const Graph &g, const vector<int> &perm) {
+  for (int i = 0; i < g.size(); ++i) {
+    for (int j = 0; j < g.size(); ++j) {
+      if (g.HasEdge(i, j) != g.HasEdge(perm[i], perm[j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(CanonizerTest, IsomorphicGraphsHaveEqualForms) {
+  const int orders[] = {1, 5, 30, 64, 65, 130, 210};
+  for (size_t t = 0; t < sizeof(kAllTypes) / sizeof(kAllTypes[0]); ++t) {
+    for (size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); ++i) {
+      const int n = orders[i];
+      Graph g(n), reversed(n), other(n);
+      AddRandomEdges(n, 10, &g);
+      Reverse(g, &reversed);
+      AddRandomEdges(n + 1, 10, &other);
+      const PackedGraph form = Canonise(kAllTypes[t], g);
+      EXPECT_TRUE(form == Canonise(kAllTypes[t], reversed))
+          << GetCanonizer(kAllTypes[t])->name() << " " << n;
+      if (n > 5) {
+        EXPECT_FALSE(form == Canonise(kAllTypes[t], other))
+            << GetCanonizer(kAllTypes[t])->name() << " " << n;
+      }
+    }
+  }
+}
+
+TEST(CanonizerTest, Selection) {
+  EXPECT_EQ(kDenseNauty, AutoCanonizer::Select(10, 0));
+  EXPECT_EQ(kDenseNauty, AutoCanonizer::Select(64, 0));
+  EXPECT_EQ(kSparseNauty, AutoCanonizer::Select(100, 300));
+  EXPECT_EQ(kDenseNauty, AutoCanonizer::Select(100, 2000));
+  EXPECT_EQ(kTraces, AutoCanonizer::Select(500, 1000));
+  EXPECT_EQ(kDenseNauty, AutoCanonizer::Select(500, 100000));
+}
+
+TEST(CanonizerTest, Stats) {
+  Canonizer *sparse = GetCanonizer(kSparseNauty);
+  Canonizer *automatic = GetCanonizer(kAutoCanonizer);
+  sparse->ResetStats();
+  automatic->ResetStats();
+  Graph g(100);
+  AddRandomEdges(1, 20, &g);
+  Canonise(kAutoCanonizer, g);
+  Canonise(kAutoCanonizer, g);
+  EXPECT_EQ(2, automatic->num_calls());
+  EXPECT_EQ(2, sparse->num_calls());
+  EXPECT_LE(0, sparse->seconds());
+  sparse->ResetStats();
+  EXPECT_EQ(0, sparse->num_calls());
+  EXPECT_EQ(0, sparse->seconds());
+}
+
+TEST(CanonizerTest, ParseCanonizerType) {
+  CanonizerType type = kDenseNauty;
+  EXPECT_TRUE(ParseCanonizerType("traces", &type));
+  EXPECT_EQ(kTraces, type);
+  EXPECT_TRUE(ParseCanonizerType("sparse", &type));
+  EXPECT_EQ(kSparseNauty, type);
+  EXPECT_TRUE(ParseCanonizerType("auto", &type));
+  EXPECT_EQ(kAutoCanonizer, type);
+  EXPECT_FALSE(ParseCanonizerType("bliss", &type));
+  EXPECT_EQ(kAutoCanonizer, type);
+}
+
+TEST(CanonizerTest, DefaultCanonizer) {
+  Graph g(80), reversed(80);
+  AddRandomEdges(7, 15, &g);
+  Reverse(g, &reversed);
+  for (size_t t = 0; t < sizeof(kAllTypes) / sizeof(kAllTypes[0]); ++t) {
+    SetDefaultCanonizer(kAllTypes[t]);
+    EXPECT_EQ(GetCanonizer(kAllTypes[t]), GetDefaultCanonizer());
+    IsomorphismChecker checker(true);
+    EXPECT_TRUE(checker.AddGraphToCheck(g));
+    EXPECT_FALSE(checker.AddGraphToCheck(reversed));
+  }
+  SetDefaultCanonizer(kAutoCanonizer);
+}
+
+TEST(CanonizerTest, AutomorphismGroup) {
+  // The Petersen graph, whose group of order 120 is transitive.
+  Graph petersen(10);
+  for (int i = 0; i < 5; ++i) {
+    petersen.AddEdge(i, (i + 1) % 5);
+    petersen.AddEdge(i, i + 5);
+    petersen.AddEdge(i + 5, (i + 2) % 5 + 5);
+  }
+  // A path, whose only non-trivial automorphism reverses it.
+  Graph path(4);
+  path.AddEdge(0, 1);
+  path.AddEdge(1, 2);
+  path.AddEdge(2, 3);
+  for (size_t t = 0; t < sizeof(kAllTypes) / sizeof(kAllTypes[0]); ++t) {
+    Canonizer *canonizer = GetCanonizer(kAllTypes[t]);
+    AutomorphismGroup group;
+    canonizer->GetAutomorphismGroup(GraphView(petersen), &group);
+    EXPECT_EQ(120, group.GetGroupSize()) << canonizer->name();
+    EXPECT_EQ(1, group.num_orbits);
+    EXPECT_EQ(vector<int>(10, 0), group.orbits);
+    EXPECT_EQ(30240, group.CountLabelledGraphs());
+    EXPECT_FALSE(group.generators.empty());
+    for (size_t i = 0; i < group.generators.size(); ++i) {
+      EXPECT_TRUE(IsAutomorphism(petersen, group.generators[i]));
+    }
+    EXPECT_TRUE(PackedGraph(10, group.canonical.data()) ==
+                Canonise(kAllTypes[t], petersen));
+
+    canonizer->GetAutomorphismGroup(GraphView(path), &group);
+    EXPECT_EQ(2, group.GetGroupSize()) << canonizer->name();
+    EXPECT_EQ(2, group.num_orbits);
+    EXPECT_EQ(vector<int>({0, 1, 1, 0}), group.orbits);
+    ASSERT_EQ(1, group.generators.size());
+    EXPECT_EQ(vector<int>({3, 2, 1, 0}), group.generators[0]);
+  }
+}
+
+TEST(CanonizerTest, CountLabelledGraphs) {
+  // Every labelled graph of order 5 is counted by its isomorphism class.
+  const int n = 5;
+  for (size_t t = 0; t < sizeof(kAllTypes) / sizeof(kAllTypes[0]); ++t) {
+    SetDefaultCanonizer(kAllTypes[t]);
+    IsomorphismChecker checker(true);
+    double labelled = 0;
+    for (int edges = 0; edges < 1 << (n * (n - 1) / 2); ++edges) {
+      Graph g(n);
+      for (int i = 0, bit = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j, ++bit) {
+          if (edges & (1 << bit)) {
+            g.AddEdge(i, j);
+          }
+        }
+      }
+      if (checker.AddGraphToCheck(g)) {
+        AutomorphismGroup group;
+        IsomorphismChecker::GetAutomorphismGroup(GraphView(g), &group);
+        labelled += group.CountLabelledGraphs();
+      }
+    }
+    EXPECT_EQ(1024, labelled) << GetCanonizer(kAllTypes[t])->name();
+  }
+  SetDefaultCanonizer(kAutoCanonizer);
+}
+
+TEST(CanonizerTest, Options) {
+  const VertexInvariant invariants[] = {kNoInvariant, kAdjTriang, kCellQuads,
+                                        kDistances, kTriples};
+  const InitialColouring colourings[] = {kNoColouring, kColourByDegree};
+  const int orders[] = {12, 70, 210};
+  for (size_t t = 0; t < sizeof(kAllTypes) / sizeof(kAllTypes[0]); ++t) {
+    Canonizer *canonizer = GetCanonizer(kAllTypes[t]);
+    for (size_t i = 0; i < sizeof(invariants) / sizeof(invariants[0]); ++i) {
+      for (size_t c = 0; c < 2; ++c) {
+        canonizer->set_options(GetOptions(invariants[i], colourings[c]));
+        for (size_t o = 0; o < sizeof(orders) / sizeof(orders[0]); ++o) {
+          const int n = orders[o];
+          Graph g(n), reversed(n), other(n);
+          AddRandomEdges(n, 8, &g);
+          Reverse(g, &reversed);
+          AddRandomEdges(n + 1, 8, &other);
+          const PackedGraph form = Canonise(kAllTypes[t], g);
+          EXPECT_TRUE(form == Canonise(kAllTypes[t], reversed))
+              << canonizer->name() << " " << i << " " << c << " " << n;
+          EXPECT_FALSE(form == Canonise(kAllTypes[t], other))
+              << canonizer->name() << " " << i << " " << c << " " << n;
+        }
+      }
+    }
+    canonizer->set_options(CanonisationOptions());
+  }
+}
+
+TEST(CanonizerTest, InitialColouring) {
+  Graph g(40);
+  AddRandomEdges(3, 6, &g);
+  // A path, whose end 0 is coloured apart from the other end.
+  Graph path(4);
+  path.AddEdge(0, 1);
+  path.AddEdge(1, 2);
+  path.AddEdge(2, 3);
+  CanonisationOptions custom = GetOptions(kNoInvariant, kCustomColouring);
+  custom.colour_vertices = [](const GraphView &h, vector<int> *colours) {
+    for (int v = 0; v < h.size(); ++v) {
+      (*colours)[v] = v == 0 ? 1 : 0;
+    }
+  };
+  for (size_t t = 0; t < sizeof(kAllTypes) / sizeof(kAllTypes[0]); ++t) {
+    Canonizer *canonizer = GetCanonizer(kAllTypes[t]);
+    // The cells keep the order of their colours.
+    canonizer->set_options(GetOptions(kNoInvariant, kColourByDegree));
+    AutomorphismGroup group;
+    canonizer->GetAutomorphismGroup(GraphView(g), &group);
+    for (int i = 0; i + 1 < g.size(); ++i) {
+      EXPECT_LE(g.Degree(group.lab[i]), g.Degree(group.lab[i + 1]))
+          << canonizer->name();
+    }
+
+    canonizer->set_options(custom);
+    canonizer->GetAutomorphismGroup(GraphView(path), &group);
+    EXPECT_EQ(1, group.GetGroupSize()) << canonizer->name();
+    EXPECT_EQ(0, group.lab[3]);
+    canonizer->set_options(CanonisationOptions());
+  }
+}
+
+} // namespace nauty_utils
@@ -0,0 +1,83 @@
+#include "concurrent_isomorphism_checker.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include "nauty_wrapper.h"
+
+namespace nauty_utils {
+
+ConcurrentIsomorphismChecker::ConcurrentIsomorphismChecker(
+    const int num_shards)
+    : num_shards_(num_shards), shards_(NULL) {
+  if (num_shards <= 0) {
+    throw std::invalid_argument("The number of shards must be positive.");
+  }
+  size_t space = num_shards * sizeof(Shard) + kCacheLineSize;
+  shard_storage_.reset(new char[space]);
+  void *first = shard_storage_.get();
+  std::align(kCacheLineSize, num_shards * sizeof(Shard), first, space);
+  shards_ = static_cast<Shard *>(first);
+  for (int i = 0; i < num_shards_; ++i) {
+    new (&shards_[i]) Shard();
+  }
+}
+
+ConcurrentIsomorphismChecker::~ConcurrentIsomorphismChecker() {
+  for (int i = 0; i < num_shards_; ++i) {
+    shards_[i].~Shard();
+  }
+}
+
+bool ConcurrentIsomorphismChecker::AddGraphToCheck(const GraphView &g) {
+  // The canonisation, which is by far the most expensive part, runs outside of
+  // the lock.
+  return AddCanonicalForm(IsomorphismChecker::GetCanonicalForm(g));
+}
+
+bool ConcurrentIsomorphismChecker::AddGraphToCheck(const Graph &g) {
+  return AddCanonicalForm(IsomorphismChecker::GetCanonicalForm(g));
+}
+
+bool ConcurrentIsomorphismChecker::AddCanonicalForm(const PackedGraph &form) {
+  // The low bits of the hash pick the bucket inside the shard, so the shard is
+  // picked by the high ones.
+  const size_t hash = std::hash<PackedGraph>()(form);
+  Shard &shard = shards_[(hash >> 32) % num_shards_];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.canonical_forms.insert(form).second;
+}
+
+size_t ConcurrentIsomorphismChecker::size() const {
+  size_t count = 0;
+  for (int i = 0; i < num_shards_; ++i) {
+    std::lock_guard<std::mutex> lock(shards_[i].mutex);
+    count += shards_[i].canonical_forms.size();
+  }
+  return count;
+}
+
+void ConcurrentIsomorphismChecker::GetAllNonIsomorphicGraphs(
+    GraphStore *store) const {
+  std::vector<PackedGraph> packed;
+  GetAllNonIsomorphicGraphs(&packed);
+  store->Reserve(store->size() + packed.size());
+  for (size_t i = 0; i < packed.size(); ++i) {
+    packed[i].Unpack(store);
+  }
+}
+
+void ConcurrentIsomorphismChecker::GetAllNonIsomorphicGraphs(
+    std::vector<PackedGraph> *packed) const {
+  const size_t first = packed->size();
+  for (int i = 0; i < num_shards_; ++i) {
+    const std::unordered_set<PackedGraph> &forms = shards_[i].canonical_forms;
+    packed->insert(packed->end(), forms.begin(), forms.end());
+  }
+  std::sort(packed->begin() + first, packed->end());
+}
+
+} // namespace nauty_utils
@@ -0,0 +1,83 @@
+// A set of pairwise non-isomorphic graphs, which many threads can add graphs to
+// at the same time. Every graph is canonised by the thread adding it (nauty
+// keeps a workspace per thread, see configure.sh) and only its canonical form
+// is kept, in one of several shards of a hash set. Each shard has a lock of
+// its own, so threads rarely wait for each other.
+
+#ifndef NAUTY_UTILS_CONCURRENT_ISOMORPHISM_CHECKER_H_
+#define NAUTY_UTILS_CONCURRENT_ISOMORPHISM_CHECKER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
+#include "graph_utils/packed_graph.h"
+
+namespace nauty_utils {
+
+using graph_utils::Graph;
+using graph_utils::GraphStore;
+using graph_utils::GraphView;
+using graph_utils::PackedGraph;
+
+class ConcurrentIsomorphismChecker {
+public:
+  static const int kDefaultShards = 64;
+
+  // Throws std::invalid_argument unless 'num_shards' is positive.
+  explicit ConcurrentIsomorphismChecker(const int num_shards = kDefaultShards);
+  ~ConcurrentIsomorphismChecker();
+
+  // Adds 'g' and returns true if no graph isomorphic to it was added before.
+  // Otherwise 'g' is not added and false is returned. Safe to call from any
+  // number of threads at once, as long as no two threads pass the same Graph,
+  // whose cached canonical form is used if it has one.
+  bool AddGraphToCheck(const GraphView &g);
+  bool AddGraphToCheck(const Graph &g);
+  // Same as above for a graph that is canonised already, e.g. by
+  // CanonicalizeBatch(). 'form' must come from the default Canonizer.
+  bool AddCanonicalForm(const PackedGraph &form);
+
+  // Returns the number of graphs added. Safe to call at any time, though the
+  // count may be stale while graphs are being added.
+  size_t size() const;
+
+  // The methods below must not run concurrently with AddGraphToCheck().
+  //
+  // Appends the canonical forms of all graphs to 'store', which must be of the
+  // same order. The graphs are sorted by their canonical forms, so the result
+  // does not depend on the order the graphs were added in or on the number of
+  // threads adding them.
+  void GetAllNonIsomorphicGraphs(GraphStore *store) const;
+  // Same as above, but the canonical forms are appended packed.
+  void GetAllNonIsomorphicGraphs(std::vector<PackedGraph> *packed) const;
+
+private:
+  static const size_t kCacheLineSize = 64;
+
+  // A shard takes whole cache lines, so threads locking neighbouring shards
+  // do not contend for a line.
+  struct alignas(kCacheLineSize) Shard {
+    std::mutex mutex;
+    std::unordered_set<PackedGraph> canonical_forms;
+  };
+
+  ConcurrentIsomorphismChecker(const ConcurrentIsomorphismChecker &);
+  ConcurrentIsomorphismChecker &
+  operator=(const ConcurrentIsomorphismChecker &);
+
+  int num_shards_;
+  // The memory of the shards. Before C++17 new[] ignores the alignment of
+  // Shard, so the shards are constructed at the first aligned address in it.
+  std::unique_ptr<char[]> shard_storage_;
+  Shard *shards_;
+};
+
+} // namespace nauty_utils
+
+#endif // NAUTY_UTILS_CONCURRENT_ISOMORPHISM_CHECKER_H_
@@ -0,0 +1,117 @@
+// Unit tests for ConcurrentIsomorphismChecker.
+
+#include "concurrent_isomorphism_checker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "graph_utils/test_graphs.h"
+#include "gtest/gtest.h"
+#include "nauty_wrapper.h"
+
+using std::vector;
+
+namespace nauty_utils {
+namespace {
+
+const int kOrder = 7;
+const int kNumGraphs = 2000;
+
+// Creates a pseudo-random graph of order kOrder in 'g'. Every graph is created
+// twice, by the seeds 2k and 2k + 1, with its vertices in a different order.
+void MakeGraph(const unsigned seed, Graph *g) {
+  if (seed % 2 == 0) {
+    graph_utils::AddRandomEdges(seed / 2, 2, g);
+    return;
+  }
+  Graph original(kOrder);
+  graph_utils::AddRandomEdges(seed / 2, 2, &original);
+  graph_utils::Reverse(original, g);
+}
+
+} // namespace
+
+TEST(ConcurrentIsomorphismCheckerTest, SingleThread) {
+  ConcurrentIsomorphismChecker checker;
+  vector<string> path1({"0110", "1000", "1001", "0010"});
+  vector<string> path2({"0100", "1010", "0101", "0010"});
+  vector<string> star({"0111", "1000", "1000", "1000"});
+  EXPECT_TRUE(checker.AddGraphToCheck(Graph(path1)));
+  EXPECT_FALSE(checker.AddGraphToCheck(Graph(path2)));
+  EXPECT_TRUE(checker.AddGraphToCheck(Graph(star)));
+  EXPECT_EQ(2, checker.size());
+
+  GraphStore store(4);
+  checker.GetAllNonIsomorphicGraphs(&store);
+  ASSERT_EQ(2, store.size());
+  EXPECT_TRUE(IsomorphismChecker::AreIsomorphic(Graph(4, store.GetRows(0)),
+                                                Graph(path1)) !=
+              IsomorphismChecker::AreIsomorphic(Graph(4, store.GetRows(1)),
+                                                Graph(path1)));
+}
+
+TEST(ConcurrentIsomorphismCheckerTest, Shards) {
+  EXPECT_THROW(ConcurrentIsomorphismChecker(0), std::invalid_argument);
+  EXPECT_THROW(ConcurrentIsomorphismChecker(-1), std::invalid_argument);
+  // A single shard holds all graphs, with the same results as many shards.
+  ConcurrentIsomorphismChecker single(1);
+  ConcurrentIsomorphismChecker sharded;
+  for (int seed = 0; seed < 200; ++seed) {
+    Graph g(kOrder);
+    MakeGraph(seed, &g);
+    const bool added = sharded.AddGraphToCheck(g);
+    EXPECT_EQ(added, single.AddGraphToCheck(g));
+    if (seed % 2 == 1) {
+      EXPECT_FALSE(added); // The graph of seed - 1, relabelled.
+    }
+  }
+  EXPECT_EQ(sharded.size(), single.size());
+}
+
+TEST(ConcurrentIsomorphismCheckerTest, ManyThreads) {
+  IsomorphismChecker sequential(true);
+  for (int seed = 0; seed < kNumGraphs; ++seed) {
+    Graph g(kOrder);
+    MakeGraph(seed, &g);
+    sequential.AddGraphToCheck(g);
+  }
+  GraphStore expected(kOrder);
+  sequential.GetAllNonIsomorphicGraphs(&expected);
+
+  vector<PackedGraph> first_result;
+  for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    ConcurrentIsomorphismChecker checker(num_threads);
+    std::atomic<int> added(0);
+    vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.push_back(std::thread([t, num_threads, &checker, &added]() {
+        for (int seed = t; seed < kNumGraphs; seed += num_threads) {
+          Graph g(kOrder);
+          MakeGraph(seed, &g);
+          if (checker.AddGraphToCheck(g)) {
+            ++added;
+          }
+        }
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+      threads[t].join();
+    }
+    EXPECT_EQ(expected.size(), checker.size());
+    EXPECT_EQ(expected.size(), added.load());
+
+    // The result does not depend on the number of threads.
+    vector<PackedGraph> result;
+    checker.GetAllNonIsomorphicGraphs(&result);
+    if (first_result.empty()) {
+      first_result = result;
+    }
+    EXPECT_TRUE(first_result == result);
+    EXPECT_TRUE(std::is_sorted(result.begin(), result.end()));
+  }
+}
+
+} // namespace nauty_utils
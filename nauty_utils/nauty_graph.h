@@ -0,0 +1,39 @@
+// Bridges between the graphs of graph_utils and nauty graphs. The adjacency
+// rows of Graph, FixedGraph and GraphView are laid out exactly as a nauty
+// 'graph' with m = WordsNeeded(n) setwords per row (see bit_utils.h), so these
+// helpers only reinterpret pointers and never copy a graph.
+
+#ifndef NAUTY_UTILS_NAUTY_GRAPH_H_
+#define NAUTY_UTILS_NAUTY_GRAPH_H_
+
+#include "graph_utils/bit_utils.h"
+#include "graph_utils/graph_store.h"
+#include "nauty/nauty.h"
+
+#if WORDSIZE != 64
+#error "nauty must be built with WORDSIZE 64 to share graphs with graph_utils."
+#endif
+
+namespace nauty_utils {
+
+static_assert(sizeof(setword) == sizeof(graph_utils::Word),
+              "A nauty setword must be a graph_utils::Word.");
+
+// Returns the rows of 'g' as a nauty graph with m = g.words_per_row(). nauty
+// does not change the graphs it canonises, so the result may be passed to
+// densenauty() and the like although 'g' is const.
+template <typename GraphType> graph *AsNautyGraph(const GraphType &g) {
+  return reinterpret_cast<graph *>(
+      const_cast<graph_utils::Word *>(g.GetRow(0)));
+}
+
+// Views the nauty graph 'g' of order 'n', with m = SETWORDSNEEDED(n), without
+// copying it. 'g' must outlive the view.
+inline graph_utils::GraphView ViewNautyGraph(const graph *g, const int n) {
+  return graph_utils::GraphView(n,
+                                reinterpret_cast<const graph_utils::Word *>(g));
+}
+
+} // namespace nauty_utils
+
+#endif // NAUTY_UTILS_NAUTY_GRAPH_H_
@@ -0,0 +1,194 @@
+// Implementation of NautyWorkspace and the batch canonisation.
+
+#include "nauty_workspace.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using graph_utils::Word;
+using graph_utils::WordsNeeded;
+using std::vector;
+
+namespace nauty_utils {
+namespace {
+
+// Returns the graph 'i' of a batch.
+GraphView GetBatchGraph(const GraphStore &graphs, const size_t i) {
+  return graphs[i];
+}
+
+GraphView GetBatchGraph(const vector<Graph *> &graphs, const size_t i) {
+  return GraphView(*graphs[i]);
+}
+
+// Stores the canonical forms of the graphs [begin, end) of 'graphs' into
+// 'forms', from 'begin' on, with the workspace of the calling thread.
+template <typename BatchType>
+void CanonicalizeRange(const BatchType &graphs, const size_t begin,
+                       const size_t end, PackedGraph *forms) {
+  NautyWorkspace *workspace = GetThreadWorkspace();
+  for (size_t i = begin; i < end; ++i) {
+    forms[i] = workspace->GetCanonicalForm(GetBatchGraph(graphs, i));
+  }
+}
+
+// The threads that canonise the parts of the batches but the first. They live
+// as long as the program, so a batch starts no threads and the workspaces of
+// the threads keep their buffers from one batch to the next.
+class BatchPool {
+public:
+  static BatchPool *Get() {
+    static BatchPool pool;
+    return &pool;
+  }
+
+  ~BatchPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    task_ready_.notify_all();
+    for (size_t t = 0; t < threads_.size(); ++t) {
+      threads_[t].join();
+    }
+  }
+
+  // Runs 'tasks[1]', 'tasks[2]', ... on the threads of the pool and
+  // 'tasks[0]' on the calling thread, and returns when all have run. The pool
+  // grows to a thread per task but the first.
+  void Run(const vector<std::function<void()> > &tasks) {
+    Batch batch;
+    batch.remaining = tasks.size() - 1;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (threads_.size() + 1 < tasks.size()) {
+        threads_.push_back(std::thread(&BatchPool::Work, this));
+      }
+      for (size_t i = 1; i < tasks.size(); ++i) {
+        queue_.push_back(std::make_pair(&tasks[i], &batch));
+      }
+    }
+    task_ready_.notify_all();
+    tasks[0]();
+    std::unique_lock<std::mutex> lock(mutex_);
+    batch_done_.wait(lock, [&batch] { return batch.remaining == 0; });
+  }
+
+private:
+  // A call of Run(), waiting for its tasks.
+  struct Batch {
+    size_t remaining;
+  };
+
+  BatchPool() : stopping_(false) {}
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      task_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return; // Stopping.
+      }
+      const std::pair<const std::function<void()> *, Batch *> task =
+          queue_.front();
+      queue_.pop_front();
+      lock.unlock();
+      (*task.first)();
+      lock.lock();
+      if (--task.second->remaining == 0) {
+        batch_done_.notify_all();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable task_ready_;
+  std::condition_variable batch_done_;
+  std::deque<std::pair<const std::function<void()> *, Batch *> > queue_;
+  std::vector<std::thread> threads_;
+  bool stopping_;
+};
+
+template <typename BatchType>
+void CanonicalizeAll(const BatchType &graphs, vector<PackedGraph> *forms,
+                     const int num_threads) {
+  const size_t first = forms->size();
+  const size_t count = graphs.size();
+  forms->resize(first + count);
+  PackedGraph *batch_forms = forms->data() + first;
+  if (num_threads <= 1 || count <= 1) {
+    CanonicalizeRange(graphs, 0, count, batch_forms);
+    return;
+  }
+  const size_t chunk = (count + num_threads - 1) / num_threads;
+  vector<std::function<void()> > tasks;
+  for (size_t begin = 0; begin < count; begin += chunk) {
+    const size_t end = std::min(begin + chunk, count);
+    tasks.push_back([&graphs, begin, end, batch_forms] {
+      CanonicalizeRange(graphs, begin, end, batch_forms);
+    });
+  }
+  BatchPool::Get()->Run(tasks);
+}
+
+} // namespace
+
+NautyWorkspace::NautyWorkspace() : canonizer_(NULL), size_(0) {}
+
+NautyWorkspace::NautyWorkspace(Canonizer *canonizer)
+    : canonizer_(canonizer), size_(0) {}
+
+void NautyWorkspace::Canonise(const GraphView &g) {
+  size_ = g.size();
+  const size_t words = size_ * WordsNeeded(size_);
+  // The buffers never shrink.
+  if (lab_.size() < static_cast<size_t>(size_)) {
+    lab_.resize(size_);
+    orbits_.resize(size_);
+  }
+  if (canonical_.size() < words) {
+    canonical_.resize(words);
+  }
+  Canonizer *canonizer =
+      canonizer_ != NULL ? canonizer_ : GetDefaultCanonizer();
+  canonizer->Canonise(g, lab_.data(), canonical_.data(), orbits_.data());
+}
+
+PackedGraph NautyWorkspace::GetCanonicalForm(const GraphView &g) {
+  Canonise(g);
+  return PackedGraph(size_, canonical_.data());
+}
+
+bool NautyWorkspace::AreIsomorphic(const GraphView &g1, const GraphView &g2) {
+  if (g1.size() != g2.size() ||
+      g1.GetNumberOfEdges() != g2.GetNumberOfEdges()) {
+    return false;
+  }
+  Canonise(g1);
+  other_canonical_.swap(canonical_);
+  Canonise(g2);
+  const size_t words = size_ * WordsNeeded(size_);
+  return std::equal(canonical_.begin(), canonical_.begin() + words,
+                    other_canonical_.begin());
+}
+
+NautyWorkspace *GetThreadWorkspace() {
+  static thread_local NautyWorkspace workspace;
+  return &workspace;
+}
+
+void CanonicalizeBatch(const GraphStore &graphs, vector<PackedGraph> *forms,
+                       const int num_threads) {
+  CanonicalizeAll(graphs, forms, num_threads);
+}
+
+void CanonicalizeBatch(const vector<Graph *> &graphs,
+                       vector<PackedGraph> *forms, const int num_threads) {
+  CanonicalizeAll(graphs, forms, num_threads);
+}
+
+} // namespace nauty_utils
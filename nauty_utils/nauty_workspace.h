@@ -0,0 +1,89 @@
+// Buffers for canonising many graphs one after another. A NautyWorkspace keeps
+// the canonical labelling and form of the last graph it canonised, and grows
+// its buffers only when a graph is larger than all graphs before it, so a
+// stream of graphs of one order costs no allocations after the first graph.
+//
+// A workspace must not be used by several threads at once; give every thread
+// one of its own. GetThreadWorkspace() keeps one for every thread, which the
+// static methods of IsomorphismChecker and CanonicalizeBatch() use.
+
+#ifndef NAUTY_UTILS_NAUTY_WORKSPACE_H_
+#define NAUTY_UTILS_NAUTY_WORKSPACE_H_
+
+#include <vector>
+
+#include "canonizer.h"
+#include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
+#include "graph_utils/packed_graph.h"
+
+namespace nauty_utils {
+
+using graph_utils::Graph;
+using graph_utils::GraphStore;
+using graph_utils::GraphView;
+using graph_utils::PackedGraph;
+
+class NautyWorkspace {
+public:
+  // Uses the Canonizer that is the default at the time of each call (see
+  // GetDefaultCanonizer()).
+  NautyWorkspace();
+  explicit NautyWorkspace(Canonizer *canonizer);
+
+  // Canonises 'g'. Its canonical labelling and form are kept until the next
+  // call.
+  void Canonise(const GraphView &g);
+
+  // The canonical labelling of the last graph: vertex lab()[i] of the graph is
+  // vertex i of its canonical form.
+  const int *lab() const { return lab_.data(); }
+  // The orbits of the last graph: orbits()[v] is the smallest vertex in the
+  // orbit of v under the automorphism group of the graph.
+  const int *orbits() const { return orbits_.data(); }
+  // The canonical form of the last graph, valid until the next call.
+  GraphView canonical() const { return GraphView(size_, canonical_.data()); }
+
+  // Canonises 'g' and returns its canonical form, packed.
+  PackedGraph GetCanonicalForm(const GraphView &g);
+
+  // Returns true if 'g1' and 'g2' are isomorphic.
+  bool AreIsomorphic(const GraphView &g1, const GraphView &g2);
+
+private:
+  NautyWorkspace(const NautyWorkspace &);
+  NautyWorkspace &operator=(const NautyWorkspace &);
+
+  // The Canonizer, or NULL for the default one.
+  Canonizer *canonizer_;
+  int size_;
+  std::vector<int> lab_;
+  std::vector<int> orbits_;
+  std::vector<graph_utils::Word> canonical_;
+  // The canonical form of the first graph of AreIsomorphic().
+  std::vector<graph_utils::Word> other_canonical_;
+};
+
+// Returns the workspace of the calling thread. Its buffers are kept for the
+// life of the thread, so they are allocated once per thread and not per call.
+// It must not be used across a call that may use it as well.
+NautyWorkspace *GetThreadWorkspace();
+
+// Appends the canonical forms of all graphs of 'graphs' to 'forms', in the
+// order of the graphs. The graphs are split into 'num_threads' contiguous
+// parts. The calling thread canonises the first part and the threads of a pool
+// the others, every thread with its own workspace (see GetThreadWorkspace()).
+// The pool is started by the first batch that needs it and is kept for the
+// later ones, growing to the most threads asked for; with a single thread the
+// calling one does all the work.
+void CanonicalizeBatch(const GraphStore &graphs,
+                       std::vector<PackedGraph> *forms,
+                       const int num_threads = 1);
+// Same as above, for graphs that are not in a store.
+void CanonicalizeBatch(const std::vector<Graph *> &graphs,
+                       std::vector<PackedGraph> *forms,
+                       const int num_threads = 1);
+
+} // namespace nauty_utils
+
+#endif // NAUTY_UTILS_NAUTY_WORKSPACE_H_
@@ -0,0 +1,93 @@
+// Unit tests for NautyWorkspace and the batch canonisation.
+
+#include "nauty_workspace.h"
+
+#include <thread>
+#include <vector>
+
+#include "graph_utils/graph_arena.h"
+#include "graph_utils/test_graphs.h"
+#include "gtest/gtest.h"
+#include "nauty_wrapper.h"
+
+using graph_utils::AddRandomEdges;
+using graph_utils::GraphArena;
+using graph_utils::Reverse;
+using std::vector;
+
+namespace nauty_utils {
+
+TEST(NautyWorkspaceTest, Canonise) {
+  NautyWorkspace workspace;
+  // The orders grow and shrink, so the buffers are reused for smaller graphs.
+  const int orders[] = {10, 70, 3, 40, 130, 7};
+  for (size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); ++i) {
+    const int n = orders[i];
+    Graph g(n), reversed(n);
+    AddRandomEdges(n, 3, &g);
+    Reverse(g, &reversed);
+    const PackedGraph form = workspace.GetCanonicalForm(GraphView(g));
+    EXPECT_TRUE(IsomorphismChecker::GetCanonicalForm(GraphView(g)) == form);
+    EXPECT_TRUE(PackedGraph(workspace.canonical()) == form);
+    for (int u = 0; u < n; ++u) {
+      for (int v = 0; v < n; ++v) {
+        ASSERT_EQ(g.HasEdge(workspace.lab()[u], workspace.lab()[v]),
+                  workspace.canonical().HasEdge(u, v));
+      }
+    }
+    EXPECT_TRUE(workspace.GetCanonicalForm(GraphView(reversed)) == form);
+    EXPECT_TRUE(workspace.AreIsomorphic(GraphView(g), GraphView(reversed)));
+  }
+  // The same number of edges, but not isomorphic.
+  vector<string> path({"0100", "1010", "0101", "0010"});
+  vector<string> star({"0111", "1000", "1000", "1000"});
+  EXPECT_FALSE(
+      workspace.AreIsomorphic(GraphView(Graph(path)), GraphView(Graph(star))));
+}
+
+TEST(NautyWorkspaceTest, CanonicalizeBatch) {
+  const int n = 12;
+  GraphArena arena;
+  vector<Graph *> graphs;
+  GraphStore store(n);
+  for (unsigned seed = 0; seed < 100; ++seed) {
+    Graph *g = arena.NewGraph(n);
+    AddRandomEdges(seed, 3, g);
+    graphs.push_back(g);
+    store.Append(*g);
+  }
+  vector<PackedGraph> expected;
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    expected.push_back(IsomorphismChecker::GetCanonicalForm(GraphView(
+        *graphs[i])));
+  }
+  for (int num_threads = 1; num_threads <= 7; num_threads += 3) {
+    // The forms are appended after what is in the result already.
+    vector<PackedGraph> from_store(1);
+    CanonicalizeBatch(store, &from_store, num_threads);
+    ASSERT_EQ(expected.size() + 1, from_store.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                           from_store.begin() + 1));
+
+    vector<PackedGraph> from_graphs;
+    CanonicalizeBatch(graphs, &from_graphs, num_threads);
+    EXPECT_TRUE(expected == from_graphs);
+  }
+  // Batches of several threads at once share the threads of the pool.
+  vector<vector<PackedGraph> > results(4);
+  vector<std::thread> callers;
+  for (size_t t = 0; t < results.size(); ++t) {
+    callers.push_back(std::thread([&graphs, &results, t] {
+      for (int round = 0; round < 10; ++round) {
+        results[t].clear();
+        CanonicalizeBatch(graphs, &results[t], 3);
+      }
+    }));
+  }
+  for (size_t t = 0; t < callers.size(); ++t) {
+    callers[t].join();
+    EXPECT_TRUE(expected == results[t]);
+  }
+}
+
+} // namespace nauty_utils
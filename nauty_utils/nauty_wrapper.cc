@@ -1,147 +1,179 @@
 
 #include "nauty_wrapper.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
-#include "nauty/nauty.h"
+#include "canonizer.h"
+#include "graph_utils/graph_fingerprint.h"
+#include "nauty_workspace.h"
+
+using std::string;
 
 namespace nauty_utils {
 
 IsomorphismChecker::IsomorphismChecker(bool optimize) { optimize_ = optimize; }
 
+void IsomorphismChecker::EnablePreFilter(const size_t expected_graphs,
+                                         const double false_positive_rate) {
+  pre_filter_.reset(
+      new graph_utils::BlockedBloomFilter(expected_graphs, false_positive_rate));
+  pre_filter_stats_ = PreFilterStats();
+}
+
 bool IsomorphismChecker::AddGraphToCheck(Graph *g) {
-  vector<Graph *> *graphs;
+  return AddGraphToCheck(GraphView(*g), GetCanonicalForm(*g), g);
+}
+
+bool IsomorphismChecker::AddGraphToCheck(const Graph &g) {
+  return AddGraphToCheck(GraphView(g), GetCanonicalForm(g), NULL);
+}
+
+bool IsomorphismChecker::AddGraphToCheck(const GraphView &g) {
+  return AddGraphToCheck(g, GetCanonicalForm(g), NULL);
+}
+
+bool IsomorphismChecker::AddGraphToCheck(const PackedGraph &g) {
+  graph_utils::WordSet rows(g.size() * graph_utils::WordsNeeded(g.size()));
+  g.Unpack(rows.data());
+  const GraphView view(g.size(), rows.data());
+  return AddGraphToCheck(view, GetCanonicalForm(view), NULL);
+}
+
+bool IsomorphismChecker::AddGraphToCheck(const GraphView &g,
+                                         const PackedGraph &form,
+                                         Graph *pointer) {
+  // Whether the exact check is needed, which it is unless the pre-filter
+  // knows the form to be new.
+  bool check = true;
+  const size_t hash = graph_utils::MixBits(form.Hash());
+  if (pre_filter_ != NULL) {
+    if (pre_filter_->MayContain(hash)) {
+      ++pre_filter_stats_.maybe_seen;
+    } else {
+      ++pre_filter_stats_.definitely_new;
+      pre_filter_->Add(hash);
+      check = false;
+    }
+  }
   if (optimize_) {
-    graphs = &(degree_to_graphs_[g->GetDegSeqString()]);
+    HashedForm hashed;
+    hashed.form = form;
+    hashed.hash = hash;
+    // The set compares the hashes first, so inserting a form the pre-filter
+    // knows to be new compares no forms unless the hashes collide.
+    if (!canonical_forms_.insert(hashed).second) {
+      return false;
+    }
   } else {
-    graphs = &graphs_;
-  }
-  for (size_t i = 0; i < graphs->size(); ++i) {
-    if (AreIsomorphic(*(*graphs)[i], *g)) {
+    if (check &&
+        std::find(forms_.begin(), forms_.end(), form) != forms_.end()) {
       return false;
     }
+    forms_.push_back(form);
+  }
+  if (check && pre_filter_ != NULL) {
+    ++pre_filter_stats_.false_positives;
+  }
+  auto store = stores_.find(g.size());
+  if (store == stores_.end()) {
+    store =
+        stores_.insert(std::make_pair(g.size(), GraphStore(g.size()))).first;
   }
-  graphs->push_back(g);
+  store->second.Append(g);
+  Entry entry;
+  entry.order = g.size();
+  entry.index = store->second.size() - 1;
+  entry.graph = pointer;
+  graphs_.push_back(entry);
   return true;
 }
 
+GraphView IsomorphismChecker::GetGraph(const Entry &entry) const {
+  return stores_.find(entry.order)->second[entry.index];
+}
+
 void IsomorphismChecker::GetAllNonIsomorphicGraphs(vector<Graph *> *v) const {
-  if (!optimize_) {
-    v->insert(v->begin(), graphs_.begin(), graphs_.end());
-    return;
+  vector<Graph *> result;
+  for (size_t i = 0; i < graphs_.size(); ++i) {
+    if (graphs_[i].graph != NULL) {
+      result.push_back(graphs_[i].graph);
+    }
   }
-  for (auto it = degree_to_graphs_.begin(); it != degree_to_graphs_.end();
-       ++it) {
-    v->insert(v->end(), it->second.begin(), it->second.end());
+  v->insert(optimize_ ? v->end() : v->begin(), result.begin(), result.end());
+}
+
+void IsomorphismChecker::GetAllNonIsomorphicGraphs(GraphStore *store) const {
+  for (size_t i = 0; i < graphs_.size(); ++i) {
+    store->Append(GetGraph(graphs_[i]));
+  }
+}
+
+void IsomorphismChecker::GetAllNonIsomorphicGraphs(
+    vector<PackedGraph> *packed) const {
+  for (size_t i = 0; i < graphs_.size(); ++i) {
+    packed->push_back(PackedGraph(GetGraph(graphs_[i])));
   }
 }
 
 bool IsomorphismChecker::AreIsomorphic(const Graph &graph_a,
                                        const Graph &graph_b) {
-  if (graph_a.size() != graph_b.size()) {
+  if (graph_a.size() != graph_b.size() ||
+      graph_a.GetNumberOfEdges() != graph_b.GetNumberOfEdges() ||
+      graph_a.GetFingerprint() != graph_b.GetFingerprint()) {
     return false;
   }
+  return GetCanonicalForm(graph_a) == GetCanonicalForm(graph_b);
+}
 
-  DYNALLSTAT(int, lab1, lab1_sz);
-  DYNALLSTAT(int, lab2, lab2_sz);
-  DYNALLSTAT(int, ptn, ptn_sz);
-  DYNALLSTAT(int, orbits, orbits_sz);
-  DYNALLSTAT(graph, g1, g1_sz);
-  DYNALLSTAT(graph, g2, g2_sz);
-  DYNALLSTAT(graph, cg1, cg1_sz);
-  DYNALLSTAT(graph, cg2, cg2_sz);
-
-  DEFAULTOPTIONS_GRAPH(options);
-  statsblk stats;
-  options.getcanon = TRUE;
-
-  int n = graph_a.size();
-  int m = SETWORDSNEEDED(n);
-  nauty_check(WORDSIZE, m, n, NAUTYVERSIONID);
-
-  DYNALLOC1(int, lab1, lab1_sz, n, "malloc");
-  DYNALLOC1(int, lab2, lab2_sz, n, "malloc");
-  DYNALLOC1(int, ptn, ptn_sz, n, "malloc");
-  DYNALLOC1(int, orbits, orbits_sz, n, "malloc");
-  DYNALLOC2(graph, g1, g1_sz, n, m, "malloc");
-  DYNALLOC2(graph, g2, g2_sz, n, m, "malloc");
-  DYNALLOC2(graph, cg1, cg1_sz, n, m, "malloc");
-  DYNALLOC2(graph, cg2, cg2_sz, n, m, "malloc");
-
-  // Make the graphs.
-
-  EMPTYGRAPH(g1, m, n);
-  EMPTYGRAPH(g2, m, n);
-
-  for (int i = 0; i < n; ++i) {
-    for (int j = i + 1; j < n; ++j) {
-      if (graph_a.HasEdge(i, j)) {
-        ADDONEEDGE(g1, i, j, m);
-      }
-      if (graph_b.HasEdge(i, j)) {
-        ADDONEEDGE(g2, i, j, m);
-      }
-    }
-  }
-
-  densenauty(g1, lab1, ptn, orbits, &options, &stats, m, n, cg1);
-  densenauty(g2, lab2, ptn, orbits, &options, &stats, m, n, cg2);
-
-  bool result = memcmp(cg1, cg2, m * sizeof(graph) * n) == 0;
-
-  DYNFREE(lab1, lab1_sz);
-  DYNFREE(lab2, lab2_sz);
-  DYNFREE(ptn, ptn_sz);
-  DYNFREE(orbits, orbits_sz);
-  DYNFREE(g1, g1_sz);
-  DYNFREE(g2, g2_sz);
-  DYNFREE(cg1, cg1_sz);
-  DYNFREE(cg2, cg2_sz);
-
-  return result;
+bool IsomorphismChecker::AreIsomorphic(const GraphView &graph_a,
+                                       const GraphView &graph_b) {
+  return GetThreadWorkspace()->AreIsomorphic(graph_a, graph_b);
 }
 
 void IsomorphismChecker::GetCanonicalLabeling(const Graph &g,
                                               vector<int> *labels) {
-  DYNALLSTAT(int, lab1, lab1_sz);
-  DYNALLSTAT(int, ptn, ptn_sz);
-  DYNALLSTAT(int, orbits, orbits_sz);
-  DYNALLSTAT(graph, g1, g1_sz);
-  DYNALLSTAT(graph, cg1, cg1_sz);
-
-  DEFAULTOPTIONS_GRAPH(options);
-  statsblk stats;
-  options.getcanon = TRUE;
-
-  int n = g.size();
-  int m = SETWORDSNEEDED(n);
-  nauty_check(WORDSIZE, m, n, NAUTYVERSIONID);
-
-  DYNALLOC1(int, lab1, lab1_sz, n, "malloc");
-  DYNALLOC1(int, ptn, ptn_sz, n, "malloc");
-  DYNALLOC1(int, orbits, orbits_sz, n, "malloc");
-  DYNALLOC2(graph, g1, g1_sz, n, m, "malloc");
-  DYNALLOC2(graph, cg1, cg1_sz, n, m, "malloc");
-
-  EMPTYGRAPH(g1, m, n);
-  for (int i = 0; i < n; ++i) {
-    for (int j = i + 1; j < n; ++j) {
-      if (g.HasEdge(i, j)) {
-        ADDONEEDGE(g1, i, j, m);
-      }
-    }
-  }
+  NautyWorkspace *workspace = GetThreadWorkspace();
+  workspace->Canonise(GraphView(g));
+  labels->insert(labels->end(), workspace->lab(), workspace->lab() + g.size());
+  g.CacheCanonicalForm(GetDefaultCanonizer()->cache_key(),
+                       std::make_shared<const PackedGraph>(
+                           g.size(), workspace->canonical().GetRow(0)));
+}
 
-  densenauty(g1, lab1, ptn, orbits, &options, &stats, m, n, cg1);
+void IsomorphismChecker::Canonise(const Graph &g, CanonicalForm *result) {
+  NautyWorkspace *workspace = GetThreadWorkspace();
+  workspace->Canonise(GraphView(g));
+  const int n = g.size();
+  result->lab.assign(workspace->lab(), workspace->lab() + n);
+  result->orbits.assign(workspace->orbits(), workspace->orbits() + n);
+  result->form = PackedGraph(workspace->canonical());
+  g.CacheCanonicalForm(GetDefaultCanonizer()->cache_key(),
+                       std::make_shared<const PackedGraph>(result->form));
+}
 
-  for (int i = 0; i < n; ++i) {
-    labels->push_back(lab1[i]);
+PackedGraph IsomorphismChecker::GetCanonicalForm(const GraphView &g) {
+  return GetThreadWorkspace()->GetCanonicalForm(g);
+}
+
+const PackedGraph &IsomorphismChecker::GetCanonicalForm(const Graph &g) {
+  const uint64_t key = GetDefaultCanonizer()->cache_key();
+  const PackedGraph *form = g.GetCachedCanonicalForm(key);
+  if (form == NULL) {
+    std::shared_ptr<const PackedGraph> computed =
+        std::make_shared<const PackedGraph>(
+            GetThreadWorkspace()->GetCanonicalForm(GraphView(g)));
+    form = computed.get();
+    g.CacheCanonicalForm(key, std::move(computed));
   }
+  return *form;
+}
 
-  DYNFREE(lab1, lab1_sz);
-  DYNFREE(ptn, ptn_sz);
-  DYNFREE(orbits, orbits_sz);
-  DYNFREE(g1, g1_sz);
-  DYNFREE(cg1, cg1_sz);
+void IsomorphismChecker::GetAutomorphismGroup(const GraphView &g,
+                                              AutomorphismGroup *group) {
+  GetDefaultCanonizer()->GetAutomorphismGroup(g, group);
 }
 
 } // nauty_utils
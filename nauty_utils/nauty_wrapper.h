@@ -3,29 +3,152 @@
 #define NAUTY_UTILS_NAUTY_WRAPPER_H_
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
+#include "graph_utils/blocked_bloom_filter.h"
 #include "graph_utils/graph.h"
+#include "graph_utils/graph_store.h"
+#include "graph_utils/packed_graph.h"
+#include "canonizer.h"
 
 namespace nauty_utils {
 
 using std::vector;
 using std::map;
 using graph_utils::Graph;
+using graph_utils::GraphStore;
+using graph_utils::GraphView;
+using graph_utils::PackedGraph;
 
+// All one canonisation of a graph g yields.
+struct CanonicalForm {
+  // Vertex lab[i] of g is vertex i of its canonical form.
+  vector<int> lab;
+  // orbits[v] is the smallest vertex in the orbit of v under Aut(g).
+  vector<int> orbits;
+  // The canonically labelled g.
+  PackedGraph form;
+};
+
+// How the pre-filter of an IsomorphismChecker has done.
+struct PreFilterStats {
+  PreFilterStats() : definitely_new(0), maybe_seen(0), false_positives(0) {}
+
+  // Graphs the filter knew to be new, which skipped the exact check.
+  long long definitely_new;
+  // Graphs the filter may have seen before, which went through the exact
+  // check, and those of them that were new after all.
+  long long maybe_seen;
+  long long false_positives;
+};
+
+// Keeps a set of pairwise non-isomorphic graphs. The rows of every graph added
+// are copied into stores of the checker, one per order, so the graphs added
+// need not outlive the checker (except when their pointers are asked for).
 class IsomorphismChecker {
 public:
+  // Every graph added is canonised once. With 'optimize' the checker keeps
+  // the canonical forms in a hash set, so adding a graph costs a lookup.
+  // Otherwise the form of a new graph is compared to the forms of all graphs
+  // added before, one by one.
   explicit IsomorphismChecker(bool optimize);
 
+  // Puts a blocked Bloom filter of the canonical forms in front of the exact
+  // check, sized for 'expected_graphs' distinct graphs at the given rate of
+  // false positives. Graphs the filter knows to be new skip the comparisons
+  // with the graphs added before: without 'optimize' the linear scan, with
+  // 'optimize' the equality checks of the hash set, whose insertion then only
+  // compares the hash computed for the filter. Must be called before any
+  // graph is added.
+  void EnablePreFilter(const size_t expected_graphs,
+                       const double false_positive_rate = 0.01);
+  const PreFilterStats &pre_filter_stats() const { return pre_filter_stats_; }
+
+  // Adds 'g' and returns true if no graph isomorphic to it was added before.
+  // Otherwise 'g' is not added and false is returned. The pointer 'g' is kept
+  // for GetAllNonIsomorphicGraphs(vector<Graph *> *). The canonical form cached
+  // by a Graph is used if it has one.
   bool AddGraphToCheck(Graph *g);
+  // Same as above, but only the copy of the rows of 'g' is kept.
+  bool AddGraphToCheck(const Graph &g);
+  bool AddGraphToCheck(const GraphView &g);
+  bool AddGraphToCheck(const PackedGraph &g);
+
+  // Appends the pointers to all graphs added by pointer, in the order they
+  // were added. Without 'optimize' they are inserted at the front of 'v'.
   void GetAllNonIsomorphicGraphs(vector<Graph *> *v) const;
+  // Appends all graphs added to 'store', which must be of the same order, in
+  // the order they were added.
+  void GetAllNonIsomorphicGraphs(GraphStore *store) const;
+  // Same as above, but the graphs are appended packed.
+  void GetAllNonIsomorphicGraphs(vector<PackedGraph> *packed) const;
+
+  // Graphs are compared by their cached fingerprints and canonical forms, so
+  // comparing a graph that has not changed since it was last compared costs
+  // no canonisation.
   static bool AreIsomorphic(const Graph &g1, const Graph &g2);
+  static bool AreIsomorphic(const GraphView &g1, const GraphView &g2);
+  // Appends the canonical labelling of 'g' to 'labels' and caches the
+  // canonical form of 'g' on the way.
   static void GetCanonicalLabeling(const Graph &g, vector<int> *labels);
+  // Stores the canonical labelling, the orbits and the canonical form of 'g'
+  // into 'result', all from a single run of the default Canonizer. The form is
+  // cached by 'g' as well.
+  static void Canonise(const Graph &g, CanonicalForm *result);
+  // Returns the canonically labelled 'g', packed. Two graphs are isomorphic
+  // iff their canonical forms are equal.
+  static PackedGraph GetCanonicalForm(const GraphView &g);
+  // Same as above, but the form is cached by 'g' under the key of the default
+  // Canonizer (see Graph::GetCachedCanonicalForm()). The reference is valid
+  // until 'g' changes or is destroyed.
+  static const PackedGraph &GetCanonicalForm(const Graph &g);
+  // Stores the canonical labelling and form of 'g', its orbits, the size of
+  // its automorphism group and generators of the group into 'group', all from
+  // a single run of the default Canonizer.
+  static void GetAutomorphismGroup(const GraphView &g,
+                                   AutomorphismGroup *group);
 
 private:
+  // A graph added to the checker.
+  struct Entry {
+    int order;
+    // The index of the graph in the store of its order.
+    size_t index;
+    // The graph as it was added, or NULL if it was added by value.
+    Graph *graph;
+  };
+
+  // A canonical form with its hash, so the hash set neither rehashes the form
+  // nor compares forms whose hashes differ.
+  struct HashedForm {
+    PackedGraph form;
+    size_t hash;
+    bool operator==(const HashedForm &other) const {
+      return hash == other.hash && form == other.form;
+    }
+  };
+  struct HashedFormHash {
+    size_t operator()(const HashedForm &f) const { return f.hash; }
+  };
+
+  bool AddGraphToCheck(const GraphView &g, const PackedGraph &form,
+                       Graph *pointer);
+  GraphView GetGraph(const Entry &entry) const;
+
   bool optimize_;
-  vector<Graph *> graphs_;
-  map<std::string, vector<Graph *>> degree_to_graphs_;
+  map<int, GraphStore> stores_;
+  // All graphs in the order they were added.
+  vector<Entry> graphs_;
+  // The canonical forms of all graphs, with 'optimize' only.
+  std::unordered_set<HashedForm, HashedFormHash> canonical_forms_;
+  // The canonical forms of all graphs in the order they were added, without
+  // 'optimize' only.
+  vector<PackedGraph> forms_;
+  // The filter in front of the above, if enabled.
+  std::unique_ptr<graph_utils::BlockedBloomFilter> pre_filter_;
+  PreFilterStats pre_filter_stats_;
 };
 
 } // namespace nauty_utils
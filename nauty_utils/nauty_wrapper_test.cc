@@ -1,6 +1,7 @@
 
 #include <fstream>
 #include "nauty_wrapper.h"
+#include "nauty_graph.h"
 #include "gtest/gtest.h"
 
 namespace nauty_utils {
@@ -173,4 +174,110 @@ TEST_F(IsomorphismCheckerTest, CanonicalLabeling) {
   }
 }
 
+TEST_F(IsomorphismCheckerTest, CanonicalForm) {
+  vector<string> v1({"0110", "1000", "1001", "0010"});
+  vector<string> v2({"0100", "1010", "0101", "0010"});
+  vector<string> v3({"0111", "1000", "1000", "1000"});
+  Graph g1(v1);
+  Graph g2(v2);
+  Graph g3(v3);
+  const PackedGraph form = IsomorphismChecker::GetCanonicalForm(GraphView(g1));
+  EXPECT_EQ(4, form.size());
+  EXPECT_EQ(3, form.GetNumberOfEdges());
+  EXPECT_TRUE(form == IsomorphismChecker::GetCanonicalForm(GraphView(g2)));
+  EXPECT_TRUE(form != IsomorphismChecker::GetCanonicalForm(GraphView(g3)));
+  // The canonical form is a graph isomorphic to the original one.
+  Graph canonical(1);
+  form.Unpack(&canonical);
+  EXPECT_TRUE(IsomorphismChecker::AreIsomorphic(g1, canonical));
+}
+
+TEST_F(IsomorphismCheckerTest, CachedCanonicalForm) {
+  vector<string> v1({"0110", "1000", "1001", "0010"});
+  vector<string> v2({"0100", "1010", "0101", "0010"});
+  Graph g1(v1);
+  Graph g2(v2);
+  const PackedGraph *form = &IsomorphismChecker::GetCanonicalForm(g1);
+  EXPECT_TRUE(*form == IsomorphismChecker::GetCanonicalForm(GraphView(g1)));
+  // The second call returns the cached form.
+  EXPECT_EQ(form, &IsomorphismChecker::GetCanonicalForm(g1));
+  EXPECT_TRUE(IsomorphismChecker::AreIsomorphic(g1, g2));
+  EXPECT_EQ(form, &IsomorphismChecker::GetCanonicalForm(g1));
+
+  // Adding an edge drops the cached form.
+  g2.AddEdge(0, 3);
+  EXPECT_FALSE(IsomorphismChecker::AreIsomorphic(g1, g2));
+  EXPECT_TRUE(IsomorphismChecker::GetCanonicalForm(g2) ==
+              IsomorphismChecker::GetCanonicalForm(GraphView(g2)));
+
+  // So does a change of the default Canonizer.
+  SetDefaultCanonizer(kTraces);
+  EXPECT_TRUE(IsomorphismChecker::GetCanonicalForm(g1) ==
+              IsomorphismChecker::GetCanonicalForm(GraphView(g1)));
+  SetDefaultCanonizer(kAutoCanonizer);
+
+  // The copy of a graph keeps its cached form.
+  const PackedGraph &cached = IsomorphismChecker::GetCanonicalForm(g1);
+  Graph copy(g1);
+  EXPECT_EQ(&cached, &IsomorphismChecker::GetCanonicalForm(copy));
+}
+
+TEST_F(IsomorphismCheckerTest, Canonise) {
+  // A path, whose ends are in one orbit and inner vertices in another.
+  vector<string> v({"0100", "1010", "0101", "0010"});
+  Graph g(v);
+  CanonicalForm canonical;
+  IsomorphismChecker::Canonise(g, &canonical);
+  vector<int> labels;
+  IsomorphismChecker::GetCanonicalLabeling(g, &labels);
+  ExpectVectorsEq<int>(labels, canonical.lab);
+  ExpectVectorsEq<int>(vector<int>({0, 1, 1, 0}), canonical.orbits);
+  EXPECT_TRUE(canonical.form ==
+              IsomorphismChecker::GetCanonicalForm(GraphView(g)));
+  // The form is cached by the graph.
+  EXPECT_TRUE(g.GetCachedCanonicalForm(GetDefaultCanonizer()->cache_key()) !=
+              NULL);
+}
+
+TEST_F(IsomorphismCheckerTest, PreFilter) {
+  for (int optimize = 0; optimize < 2; ++optimize) {
+    checker_.reset(new IsomorphismChecker(optimize));
+    checker_->EnablePreFilter(100);
+    AddGraphToCheckFromFile(kGraphsSize22FileName);
+    vector<Graph *> result;
+    checker_->GetAllNonIsomorphicGraphs(&result);
+    EXPECT_EQ(3, result.size());
+    // Every graph is counted once, and the new ones the filter may have seen
+    // are its false positives.
+    const PreFilterStats &stats = checker_->pre_filter_stats();
+    EXPECT_LE(stats.definitely_new, 3);
+    EXPECT_EQ(3, stats.definitely_new + stats.false_positives);
+    EXPECT_LE(stats.false_positives, stats.maybe_seen);
+    EXPECT_LT(0, stats.maybe_seen);
+  }
+}
+
+TEST(NautyGraphTest, GraphRowsAreNautyRows) {
+  // A graph of order 70 takes two setwords per row.
+  const int n = 70;
+  const int m = SETWORDSNEEDED(n);
+  Graph g(n);
+  vector<graph> expected(n * m, 0);
+  for (int v = 0; v < n; ++v) {
+    for (int u = v + 1; u < n; u += v + 1) {
+      g.AddEdge(v, u);
+      ADDONEEDGE(expected.data(), v, u, m);
+    }
+  }
+  ASSERT_EQ(m, g.words_per_row());
+  EXPECT_EQ(0, memcmp(expected.data(), AsNautyGraph(g),
+                      n * m * sizeof(graph)));
+
+  const GraphView view = ViewNautyGraph(expected.data(), n);
+  EXPECT_EQ(g.GetNumberOfEdges(), view.GetNumberOfEdges());
+  EXPECT_TRUE(view.HasEdge(69, 0));
+  EXPECT_TRUE(view.HasEdge(3, 68));
+  EXPECT_FALSE(view.HasEdge(3, 67));
+}
+
 } // namespace nauty_utils
@@ -29,4 +29,44 @@ do
         echo -e "\e[31mFAILED nauty_wrapper_test\e[0m"
         exit 1
     }
+    ./fixed_graph_test.exe || {
+        echo -e "\e[31mFAILED fixed_graph_test\e[0m"
+        exit 1
+    }
+    ./graph_arena_test.exe || {
+        echo -e "\e[31mFAILED graph_arena_test\e[0m"
+        exit 1
+    }
+    ./graph_store_test.exe || {
+        echo -e "\e[31mFAILED graph_store_test\e[0m"
+        exit 1
+    }
+    ./packed_graph_test.exe || {
+        echo -e "\e[31mFAILED packed_graph_test\e[0m"
+        exit 1
+    }
+    ./graph_fingerprint_test.exe || {
+        echo -e "\e[31mFAILED graph_fingerprint_test\e[0m"
+        exit 1
+    }
+    ./concurrent_isomorphism_checker_test.exe || {
+        echo -e "\e[31mFAILED concurrent_isomorphism_checker_test\e[0m"
+        exit 1
+    }
+    ./canonizer_test.exe || {
+        echo -e "\e[31mFAILED canonizer_test\e[0m"
+        exit 1
+    }
+    ./nauty_workspace_test.exe || {
+        echo -e "\e[31mFAILED nauty_workspace_test\e[0m"
+        exit 1
+    }
+    ./canonical_form_index_test.exe || {
+        echo -e "\e[31mFAILED canonical_form_index_test\e[0m"
+        exit 1
+    }
+    ./blocked_bloom_filter_test.exe || {
+        echo -e "\e[31mFAILED blocked_bloom_filter_test\e[0m"
+        exit 1
+    }
 done